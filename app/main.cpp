@@ -1,11 +1,49 @@
 #include <iostream>
+#include <string>
+#include <vector>
 
 #include "config.hpp"
 #include "ellipsoid.hpp"
+#include "ellipsoid_catalog.hpp"
 #include <Eigen/Core>
 
-int main()
+/**
+ * @brief Converts a text catalog (one "a b c x y z [r00 ... r22]" line per ellipsoid) to a binary catalog.
+ */
+int convertCatalog(const std::string& input_path, const std::string& output_path)
 {
+    std::vector<Ellipsoid> ellipsoids;
+    std::size_t line_number;
+    if (!EllipsoidCatalog::readText(input_path, ellipsoids, line_number))
+    {
+        std::cerr << "Failed to read " << input_path;
+        if (line_number > 0) { std::cerr << " at line " << line_number; }
+        std::cerr << '\n';
+        return 1;
+    }
+
+    if (!EllipsoidCatalog::write(output_path, ellipsoids))
+    {
+        std::cerr << "Failed to write " << output_path << '\n';
+        return 1;
+    }
+
+    std::cout << "Wrote " << ellipsoids.size() << " ellipsoids to " << output_path << '\n';
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc > 1 && std::string(argv[1]) == "convert")
+    {
+        if (argc != 4)
+        {
+            std::cerr << "Usage: " << argv[0] << " convert <input.txt> <output.eorl>\n";
+            return 1;
+        }
+        return convertCatalog(argv[2], argv[3]);
+    }
+
     std::cout << project_name << '\n';
     std::cout << project_version << '\n';
 
@@ -0,0 +1,33 @@
+/**
+ * @file benchmark_timer.hpp
+ * @brief Wall-clock timing shared by the benchmark executables.
+ *
+ * Usage:
+ * @code
+ * double seconds = timeQuery([&]() { solver.computeDistances(starts, ends, workspace); });
+ * @endcode
+ */
+#ifndef BENCHMARK_TIMER_HPP
+#define BENCHMARK_TIMER_HPP
+
+#include <algorithm>
+#include <chrono>
+
+/**
+ * @brief Returns the time taken per call of query, in seconds, taking the best of three runs.
+ */
+template<typename Query>
+double timeQuery(Query query)
+{
+    double best = 1.0e300;
+    for (int run = 0; run < 3; run++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        query();
+        auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(end - start).count());
+    }
+    return best;
+}
+
+#endif // BENCHMARK_TIMER_HPP
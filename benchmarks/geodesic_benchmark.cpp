@@ -0,0 +1,167 @@
+/**
+ * @file geodesic_benchmark.cpp
+ * @brief Measures the accuracy and throughput of the GeodesicSolver.
+ *
+ * Accuracy is reported against the closed form on a sphere, against the numerical method on the WGS84
+ * spheroid (each method is an independent check of the other), and against published WGS84 reference lengths.
+ * Throughput is reported in point pairs per second for each method, using the batch interface.
+ *
+ * Usage:
+ * @code
+ * ./run_geodesic_benchmark.exe [pair_count]
+ * @endcode
+ */
+#include "benchmark_timer.hpp"
+#include "geodesic_solver.hpp"
+#include "workspace.hpp"
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+namespace
+{
+    const double pi = std::acos(-1.0);
+
+    /**
+     * @brief Returns pair_count surface points at uniformly random directions from the centre of the ellipsoid.
+     */
+    Eigen::Matrix3Xd generateSurfacePoints(const Ellipsoid& ellipsoid, Eigen::Index pair_count, std::mt19937_64& generator)
+    {
+        std::normal_distribution<double> normal(0.0, 1.0);
+        Eigen::Vector3d axes(ellipsoid.getA(), ellipsoid.getB(), ellipsoid.getC());
+        Eigen::Matrix3Xd points(3, pair_count);
+        for (Eigen::Index i = 0; i < pair_count; i++)
+        {
+            Eigen::Vector3d direction(normal(generator), normal(generator), normal(generator));
+            Eigen::Vector3d local = direction.normalized().cwiseProduct(axes);
+            points.col(i) = ellipsoid.getRotationMatrix() * local + ellipsoid.getPositionVector();
+        }
+        return points;
+    }
+
+    void reportDifferences(const char* label, const Eigen::VectorXd& values, const Eigen::VectorXd& reference)
+    {
+        Eigen::ArrayXd relative = ((values - reference).array() / reference.array().max(1.0e-300)).abs();
+        std::cout << "  " << std::left << std::setw(36) << label << std::right << std::scientific << std::setprecision(2)
+                  << "max relative " << relative.maxCoeff() << ", mean relative " << relative.mean() << "\n";
+    }
+
+    void reportThroughput(const char* label, Eigen::Index pair_count, double seconds)
+    {
+        std::cout << "  " << std::left << std::setw(36) << label << std::right << std::fixed << std::setprecision(0)
+                  << static_cast<double>(pair_count) / seconds << " pairs/s\n";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Eigen::Index pair_count = argc > 1 ? std::atol(argv[1]) : 2000;
+    Eigen::Index numerical_count = std::max<Eigen::Index>(1, pair_count / 20);
+    std::mt19937_64 generator(20240613);
+    Workspace workspace;
+
+    Ellipsoid sphere(6371000.0, 6371000.0, 6371000.0);
+    Ellipsoid wgs84(6378137.0, 6378137.0, 6356752.314245);
+    Ellipsoid triaxial(3.0, 2.0, 1.0);
+
+    std::cout << "Geodesic accuracy\n";
+
+    // Sphere: closed form against the numerical method, and against the great circle angle
+    {
+        GeodesicSolver solver(sphere);
+        Eigen::Matrix3Xd starts = generateSurfacePoints(sphere, numerical_count, generator);
+        Eigen::Matrix3Xd ends = generateSurfacePoints(sphere, numerical_count, generator);
+        Eigen::VectorXd reference(numerical_count);
+        for (Eigen::Index i = 0; i < numerical_count; i++)
+        {
+            Eigen::Vector3d u = starts.col(i).normalized();
+            Eigen::Vector3d v = ends.col(i).normalized();
+            reference[i] = sphere.getA() * std::atan2(u.cross(v).norm(), u.dot(v));
+        }
+        workspace.reset();
+        Eigen::VectorXd closed_form = solver.computeDistances(starts, ends, workspace);
+        Eigen::VectorXd numerical = solver.computeDistances(starts, ends, workspace, GeodesicMethod::Numerical);
+        reportDifferences("sphere, closed form", closed_form, reference);
+        reportDifferences("sphere, numerical", numerical, reference);
+    }
+
+    // WGS84: series against numerical, on random pairs away from the antipodal region
+    {
+        GeodesicSolver solver(wgs84);
+        Eigen::Matrix3Xd starts = generateSurfacePoints(wgs84, numerical_count, generator);
+        Eigen::Matrix3Xd ends = generateSurfacePoints(wgs84, numerical_count, generator);
+        for (Eigen::Index i = 0; i < numerical_count; i++)
+        {
+            if (starts.col(i).normalized().dot(ends.col(i).normalized()) < -0.9) { ends.col(i) *= -1.0; }
+        }
+        workspace.reset();
+        Eigen::VectorXd series = solver.computeDistances(starts, ends, workspace, GeodesicMethod::SpheroidSeries);
+        Eigen::VectorXd numerical = solver.computeDistances(starts, ends, workspace, GeodesicMethod::Numerical);
+        reportDifferences("WGS84, series against numerical", series, numerical);
+
+        // Published lengths of the WGS84 quarter meridian and quarter equator
+        Eigen::VectorXd reference(2);
+        reference << 10001965.729, 10018754.171;
+        Eigen::VectorXd quarters(2);
+        quarters[0] = solver.computeDistance(Eigen::Vector3d(6378137.0, 0.0, 0.0), Eigen::Vector3d(0.0, 0.0, 6356752.314245));
+        quarters[1] = solver.computeDistance(Eigen::Vector3d(6378137.0, 0.0, 0.0), Eigen::Vector3d(0.0, 6378137.0, 0.0));
+        reportDifferences("WGS84, quarter meridian and equator", quarters, reference);
+    }
+
+    // Triaxial: the distance should not depend on the direction of travel, away from the antipodal region where
+    // the two directions may converge to different local geodesics
+    {
+        GeodesicSolver solver(triaxial);
+        Eigen::Matrix3Xd starts = generateSurfacePoints(triaxial, numerical_count, generator);
+        Eigen::Matrix3Xd ends = generateSurfacePoints(triaxial, numerical_count, generator);
+        for (Eigen::Index i = 0; i < numerical_count; i++)
+        {
+            if (starts.col(i).normalized().dot(ends.col(i).normalized()) < -0.9) { ends.col(i) *= -1.0; }
+        }
+        workspace.reset();
+        Eigen::VectorXd forward = solver.computeDistances(starts, ends, workspace);
+        Eigen::VectorXd backward = solver.computeDistances(ends, starts, workspace);
+        reportDifferences("triaxial, forward against backward", forward, backward);
+    }
+
+    std::cout << "\nGeodesic throughput\n";
+
+    {
+        GeodesicSolver solver(sphere);
+        Eigen::Matrix3Xd starts = generateSurfacePoints(sphere, pair_count, generator);
+        Eigen::Matrix3Xd ends = generateSurfacePoints(sphere, pair_count, generator);
+        double seconds = timeQuery([&]() { workspace.reset(); solver.computeDistances(starts, ends, workspace); });
+        reportThroughput("sphere, closed form", pair_count, seconds);
+    }
+
+    {
+        GeodesicSolver solver(wgs84);
+        Eigen::Matrix3Xd starts = generateSurfacePoints(wgs84, pair_count, generator);
+        Eigen::Matrix3Xd ends = generateSurfacePoints(wgs84, pair_count, generator);
+        double seconds = timeQuery([&]() { workspace.reset(); solver.computeDistances(starts, ends, workspace); });
+        reportThroughput("WGS84, series", pair_count, seconds);
+
+        auto numerical_starts = starts.leftCols(numerical_count);
+        auto numerical_ends = ends.leftCols(numerical_count);
+        seconds = timeQuery([&]() {
+            workspace.reset();
+            solver.computeDistances(numerical_starts, numerical_ends, workspace, GeodesicMethod::Numerical);
+        });
+        reportThroughput("WGS84, numerical", numerical_count, seconds);
+    }
+
+    {
+        GeodesicSolver solver(triaxial);
+        Eigen::Matrix3Xd starts = generateSurfacePoints(triaxial, numerical_count, generator);
+        Eigen::Matrix3Xd ends = generateSurfacePoints(triaxial, numerical_count, generator);
+        double seconds = timeQuery([&]() { workspace.reset(); solver.computeDistances(starts, ends, workspace); });
+        reportThroughput("triaxial, numerical", numerical_count, seconds);
+    }
+
+    return 0;
+}
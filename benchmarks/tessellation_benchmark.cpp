@@ -0,0 +1,107 @@
+/**
+ * @file tessellation_benchmark.cpp
+ * @brief Measures the time taken by the Tessellator to mesh a large batch of ellipsoids and ellipses.
+ *
+ * The buffers are sized from the layout and allocated once, before timing, so the reported wall time covers
+ * only planning and writing the meshes. Each batch is timed with adaptive refinement levels and with a fixed
+ * level, and the best of three runs is reported.
+ *
+ * Usage:
+ * @code
+ * ./run_tessellation_benchmark.exe [ellipsoid_count]
+ * @endcode
+ */
+#include "benchmark_timer.hpp"
+#include "ellipse.hpp"
+#include "ellipsoid.hpp"
+#include "tessellator.hpp"
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+    const double pi = std::acos(-1.0);
+
+    void reportTime(const char* label, std::size_t shape_count, std::size_t vertex_count, double seconds)
+    {
+        std::cout << "  " << std::left << std::setw(36) << label << std::right << std::fixed << std::setprecision(2)
+                  << 1000.0 * seconds << " ms, " << shape_count << " shapes, " << vertex_count << " vertices, "
+                  << std::setprecision(0) << static_cast<double>(vertex_count) / seconds << " vertices/s\n";
+    }
+
+    /**
+     * @brief Plans and writes the meshes of the batch into preallocated buffers, reporting the best wall time.
+     */
+    template<typename Plan>
+    void timeEllipsoidBatch(const char* label, const Tessellator& tessellator, const std::vector<Ellipsoid>& ellipsoids,
+                            Plan plan)
+    {
+        EllipsoidMeshLayout layout = plan();
+        std::vector<float> vertices(3 * layout.vertex_count);
+        std::vector<float> normals(3 * layout.vertex_count);
+        std::vector<std::uint32_t> indices(layout.index_count);
+
+        double seconds = timeQuery([&]() {
+            EllipsoidMeshLayout timed_layout = plan();
+            tessellator.tessellateEllipsoids(ellipsoids, timed_layout, vertices.data(), normals.data(), indices.data());
+        });
+        reportTime(label, ellipsoids.size(), layout.vertex_count, seconds);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::size_t ellipsoid_count = argc > 1 ? static_cast<std::size_t>(std::atol(argv[1])) : 100000;
+    std::mt19937_64 generator(20240613);
+    std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+
+    std::vector<Ellipsoid> ellipsoids;
+    std::vector<Ellipse> ellipses;
+    ellipsoids.reserve(ellipsoid_count);
+    ellipses.reserve(ellipsoid_count);
+    for (std::size_t i = 0; i < ellipsoid_count; i++)
+    {
+        Ellipsoid ellipsoid(1.0 + 0.5 * uniform(generator), 0.7 + 0.2 * uniform(generator), 0.4 + 0.1 * uniform(generator));
+        ellipsoid.setPositionVector(100.0 * uniform(generator), 100.0 * uniform(generator), 100.0 * uniform(generator));
+        Eigen::Matrix3d rotation = Eigen::AngleAxisd(pi * uniform(generator),
+            Eigen::Vector3d(uniform(generator), uniform(generator), uniform(generator)).normalized()).toRotationMatrix();
+        ellipsoid.setRotationMatrix(rotation);
+        ellipsoids.push_back(ellipsoid);
+
+        Ellipse ellipse(ellipsoid.getA(), ellipsoid.getB());
+        Eigen::Vector2d position(100.0 * uniform(generator), 100.0 * uniform(generator));
+        ellipse.setPositionVector(position);
+        ellipses.push_back(ellipse);
+    }
+
+    std::cout << "Ellipsoid meshes\n";
+
+    for (SphereTemplate template_type : {SphereTemplate::Icosphere, SphereTemplate::UVSphere})
+    {
+        Tessellator tessellator(template_type);
+        bool icosphere = template_type == SphereTemplate::Icosphere;
+        timeEllipsoidBatch(icosphere ? "icosphere, tolerance 1e-1" : "UV sphere, tolerance 1e-1", tessellator,
+                           ellipsoids, [&]() { return tessellator.planEllipsoids(ellipsoids, 1.0e-1); });
+        timeEllipsoidBatch(icosphere ? "icosphere, level 1" : "UV sphere, level 1", tessellator, ellipsoids,
+                           [&]() { return tessellator.planEllipsoids(ellipsoids, 1); });
+    }
+
+    std::cout << "\nEllipse polylines\n";
+
+    {
+        const int point_count = 64;
+        std::vector<float> vertices(2 * point_count * ellipses.size());
+        double seconds = timeQuery([&]() { Tessellator::tessellateEllipses(ellipses, point_count, vertices.data()); });
+        reportTime("64 points per ellipse", ellipses.size(), point_count * ellipses.size(), seconds);
+    }
+
+    return 0;
+}
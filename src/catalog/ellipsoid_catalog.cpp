@@ -0,0 +1,293 @@
+#include "ellipsoid_catalog.hpp"
+#include "workspace.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+    constexpr char magic[8] = {'E', 'O', 'R', 'L', 'C', 'A', 'T', '\0'};
+    constexpr std::size_t array_count = static_cast<std::size_t>(CatalogArray::Count);
+
+    /**
+     * @brief Byte offsets of the header fields.
+     */
+    constexpr std::size_t version_offset = 8;
+    constexpr std::size_t array_count_offset = 12;
+    constexpr std::size_t ellipsoid_count_offset = 16;
+    constexpr std::size_t array_offsets_offset = 24;
+    constexpr std::size_t header_size = array_offsets_offset + 8 * array_count;
+
+    bool isLittleEndianHost()
+    {
+        const std::uint16_t probe = 1;
+        unsigned char first_byte;
+        std::memcpy(&first_byte, &probe, 1);
+        return first_byte == 1;
+    }
+
+    std::uint64_t loadLittleEndian(const std::byte* source, int byte_count)
+    {
+        std::uint64_t value = 0;
+        for (int i = 0; i < byte_count; i++)
+        {
+            value |= static_cast<std::uint64_t>(source[i]) << (8 * i);
+        }
+        return value;
+    }
+
+    void storeLittleEndian(std::byte* destination, std::uint64_t value, int byte_count)
+    {
+        for (int i = 0; i < byte_count; i++)
+        {
+            destination[i] = static_cast<std::byte>((value >> (8 * i)) & 0xFF);
+        }
+    }
+
+    void storeDouble(std::byte* destination, double value)
+    {
+        std::uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        storeLittleEndian(destination, bits, 8);
+    }
+
+    std::size_t alignUp(std::size_t offset)
+    {
+        return (offset + EllipsoidCatalog::alignment - 1) / EllipsoidCatalog::alignment * EllipsoidCatalog::alignment;
+    }
+
+    std::size_t getElementSize(std::size_t array)
+    {
+        return array == static_cast<std::size_t>(CatalogArray::Form) ? 1 : 8;
+    }
+}
+
+bool EllipsoidCatalog::open(const std::string& path)
+{
+    close();
+    if (!isLittleEndianHost() || !file.open(path)) { return false; }
+
+    const std::byte* data = file.getData();
+    std::size_t size = file.getSize();
+    bool valid = size >= header_size &&
+                 std::memcmp(data, magic, sizeof(magic)) == 0 &&
+                 loadLittleEndian(data + version_offset, 4) == version &&
+                 loadLittleEndian(data + array_count_offset, 4) == array_count;
+
+    std::uint64_t count = valid ? loadLittleEndian(data + ellipsoid_count_offset, 8) : 0;
+    valid = valid && count <= size;
+
+    for (std::size_t array = 0; valid && array < array_count; array++)
+    {
+        std::uint64_t offset = loadLittleEndian(data + array_offsets_offset + 8 * array, 8);
+        std::size_t element_size = getElementSize(array);
+        valid = offset >= header_size && offset % alignment == 0 && offset <= size &&
+                count <= (size - offset) / element_size;
+        if (!valid) { break; }
+
+        if (array == static_cast<std::size_t>(CatalogArray::Form))
+        {
+            forms = reinterpret_cast<const std::uint8_t*>(data + offset);
+        }
+        else
+        {
+            arrays[array] = reinterpret_cast<const double*>(data + offset);
+        }
+    }
+
+    // Forms are passed on as EllipsoidForm values, so every byte must name one
+    for (std::uint64_t i = 0; valid && i < count; i++)
+    {
+        valid = forms[i] <= static_cast<std::uint8_t>(EllipsoidForm::Triaxial);
+    }
+
+    if (!valid)
+    {
+        close();
+        return false;
+    }
+
+    ellipsoid_count = static_cast<std::size_t>(count);
+    return true;
+}
+
+void EllipsoidCatalog::close()
+{
+    file.close();
+    ellipsoid_count = 0;
+    arrays.fill(nullptr);
+    forms = nullptr;
+}
+
+ConstVectorXdMap EllipsoidCatalog::getSemiAxes(int axis) const
+{
+    auto array = static_cast<CatalogArray>(static_cast<int>(CatalogArray::SemiAxisA) + axis);
+    return ConstVectorXdMap(getDoubleArray(array), ellipsoid_count);
+}
+
+ConstVectorXdMap EllipsoidCatalog::getPositions(int coordinate) const
+{
+    auto array = static_cast<CatalogArray>(static_cast<int>(CatalogArray::PositionX) + coordinate);
+    return ConstVectorXdMap(getDoubleArray(array), ellipsoid_count);
+}
+
+ConstVectorXdMap EllipsoidCatalog::getRotations(int row, int column) const
+{
+    auto array = static_cast<CatalogArray>(static_cast<int>(CatalogArray::Rotation00) + 3 * row + column);
+    return ConstVectorXdMap(getDoubleArray(array), ellipsoid_count);
+}
+
+ConstVectorXdMap EllipsoidCatalog::getInverseSquaredSemiAxes(int axis) const
+{
+    auto array = static_cast<CatalogArray>(static_cast<int>(CatalogArray::InverseSquaredSemiAxisA) + axis);
+    return ConstVectorXdMap(getDoubleArray(array), ellipsoid_count);
+}
+
+ConstVectorXdMap EllipsoidCatalog::getBoundingRadii() const
+{
+    return ConstVectorXdMap(getDoubleArray(CatalogArray::BoundingRadius), ellipsoid_count);
+}
+
+Ellipsoid EllipsoidCatalog::getEllipsoid(std::size_t index) const
+{
+    std::array<double, 3> semi_axes;
+    Eigen::Vector3d position;
+    Eigen::Matrix3d orientation;
+    for (int i = 0; i < 3; i++)
+    {
+        semi_axes[i] = getSemiAxes(i)[index];
+        position[i] = getPositions(i)[index];
+        for (int j = 0; j < 3; j++) { orientation(i, j) = getRotations(i, j)[index]; }
+    }
+
+    return Ellipsoid(semi_axes, position, orientation, getForm(index));
+}
+
+bool EllipsoidCatalog::isInside(std::size_t index, const Eigen::Vector3d& point) const
+{
+    Eigen::Vector3d relative;
+    for (int i = 0; i < 3; i++) { relative[i] = point[i] - getPositions(i)[index]; }
+
+    double bounding_radius = getBoundingRadii()[index];
+    if (relative.squaredNorm() > bounding_radius * bounding_radius) { return false; }
+
+    // The local coordinates are the projections onto the columns of the rotation
+    double level = 0.0;
+    for (int j = 0; j < 3; j++)
+    {
+        double local = getRotations(0, j)[index] * relative[0] + getRotations(1, j)[index] * relative[1] +
+                       getRotations(2, j)[index] * relative[2];
+        level += local * local * getInverseSquaredSemiAxes(j)[index];
+    }
+
+    return level <= 1.0;
+}
+
+ArrayXbMap EllipsoidCatalog::computeContainment(const Eigen::Vector3d& point, Workspace& workspace) const
+{
+    Eigen::Index count = static_cast<Eigen::Index>(ellipsoid_count);
+    ArrayXbMap inside(workspace.allocate<bool>(ellipsoid_count), count);
+
+    #pragma omp parallel for schedule(static)
+    for (Eigen::Index i = 0; i < count; i++)
+    {
+        inside[i] = isInside(static_cast<std::size_t>(i), point);
+    }
+
+    return inside;
+}
+
+bool EllipsoidCatalog::write(const std::string& path, const std::vector<Ellipsoid>& ellipsoids)
+{
+    std::size_t count = ellipsoids.size();
+
+    std::array<std::size_t, array_count> offsets;
+    std::size_t file_size = header_size;
+    for (std::size_t array = 0; array < array_count; array++)
+    {
+        offsets[array] = alignUp(file_size);
+        file_size = offsets[array] + count * getElementSize(array);
+    }
+
+    std::vector<std::byte> image(file_size, std::byte{0});
+    std::memcpy(image.data(), magic, sizeof(magic));
+    storeLittleEndian(image.data() + version_offset, version, 4);
+    storeLittleEndian(image.data() + array_count_offset, array_count, 4);
+    storeLittleEndian(image.data() + ellipsoid_count_offset, count, 8);
+    for (std::size_t array = 0; array < array_count; array++)
+    {
+        storeLittleEndian(image.data() + array_offsets_offset + 8 * array, offsets[array], 8);
+    }
+
+    auto storeEntry = [&image, &offsets](CatalogArray array, std::size_t index, double value)
+    {
+        storeDouble(image.data() + offsets[static_cast<std::size_t>(array)] + 8 * index, value);
+    };
+
+    for (std::size_t i = 0; i < count; i++)
+    {
+        const Ellipsoid& ellipsoid = ellipsoids[i];
+        const Eigen::Vector3d semi_axes(ellipsoid.getA(), ellipsoid.getB(), ellipsoid.getC());
+        const Eigen::Vector3d position = ellipsoid.getPositionVector();
+        const Eigen::Matrix3d orientation = ellipsoid.getRotationMatrix();
+
+        for (int k = 0; k < 3; k++)
+        {
+            storeEntry(static_cast<CatalogArray>(static_cast<int>(CatalogArray::SemiAxisA) + k), i, semi_axes[k]);
+            storeEntry(static_cast<CatalogArray>(static_cast<int>(CatalogArray::PositionX) + k), i, position[k]);
+            storeEntry(static_cast<CatalogArray>(static_cast<int>(CatalogArray::InverseSquaredSemiAxisA) + k), i,
+                       1.0 / (semi_axes[k] * semi_axes[k]));
+            for (int j = 0; j < 3; j++)
+            {
+                storeEntry(static_cast<CatalogArray>(static_cast<int>(CatalogArray::Rotation00) + 3 * k + j), i,
+                           orientation(k, j));
+            }
+        }
+        storeEntry(CatalogArray::BoundingRadius, i, semi_axes.maxCoeff());
+        image[offsets[static_cast<std::size_t>(CatalogArray::Form)] + i] =
+            static_cast<std::byte>(static_cast<std::uint8_t>(ellipsoid.getForm()));
+    }
+
+    std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+    if (!stream) { return false; }
+    stream.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+
+    return static_cast<bool>(stream);
+}
+
+bool EllipsoidCatalog::readText(const std::string& path, std::vector<Ellipsoid>& ellipsoids, std::size_t& line_number)
+{
+    line_number = 0;
+    std::ifstream stream(path);
+    if (!stream) { return false; }
+
+    std::string line;
+    while (std::getline(stream, line))
+    {
+        line_number++;
+        std::size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') { continue; }
+
+        std::istringstream fields(line);
+        std::vector<double> values;
+        double value;
+        while (fields >> value) { values.push_back(value); }
+        if (!fields.eof() || (values.size() != 6 && values.size() != 15)) { return false; }
+        if (std::min({values[0], values[1], values[2]}) <= 0.0) { return false; }
+
+        Ellipsoid ellipsoid(values[0], values[1], values[2]);
+        ellipsoid.setPositionVector(values[3], values[4], values[5]);
+        if (values.size() == 15)
+        {
+            Eigen::Matrix3d rotation;
+            rotation << values[6], values[7], values[8],
+                        values[9], values[10], values[11],
+                        values[12], values[13], values[14];
+            ellipsoid.setRotationMatrix(rotation);
+        }
+        ellipsoids.push_back(ellipsoid);
+    }
+
+    return true;
+}
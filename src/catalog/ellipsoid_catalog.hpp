@@ -0,0 +1,187 @@
+/**
+ * @file ellipsoid_catalog.hpp
+ * @brief Defines the EllipsoidCatalog class, a memory-mapped binary catalog of ellipsoids in structure-of-arrays form.
+ *
+ * A catalog file is a header followed by one array per field, each starting on a 64-byte boundary. All values
+ * are little-endian. The header holds the magic bytes "EORLCAT\0", the format version (uint32), the number of
+ * arrays (uint32) and ellipsoids (uint64), and then the byte offset of each array (uint64). Besides the
+ * semi-axes, position and rotation, the file stores the form of each ellipsoid and constants used by queries
+ * (inverse squared semi-axes and bounding radius), so nothing is recomputed on load.
+ *
+ * Opening a catalog maps the file and validates the header and the one-byte forms, so the only per-ellipsoid
+ * work on load is a scan of one byte each. The arrays are then used in place.
+ *
+ * Usage:
+ * @code
+ * EllipsoidCatalog::write("catalog.eorl", ellipsoids);
+ *
+ * EllipsoidCatalog catalog;
+ * if (catalog.open("catalog.eorl"))
+ * {
+ *     double largest_a = catalog.getSemiAxes(0).maxCoeff();
+ *     Ellipsoid first = catalog.getEllipsoid(0);
+ * }
+ * @endcode
+ */
+#ifndef ELLIPSOID_CATALOG_HPP
+#define ELLIPSOID_CATALOG_HPP
+
+#include "ellipsoid.hpp"
+#include "mapped_file.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <Eigen/Core>
+
+/**
+ * @brief The arrays of a catalog file, in the order of their offsets in the header.
+ *
+ * Rotation entries are stored as separate arrays in row-major order. Form is one byte per ellipsoid, holding
+ * the EllipsoidForm value; every other array holds doubles.
+ */
+enum class CatalogArray : std::uint32_t
+{
+    SemiAxisA,
+    SemiAxisB,
+    SemiAxisC,
+    PositionX,
+    PositionY,
+    PositionZ,
+    Rotation00,
+    Rotation01,
+    Rotation02,
+    Rotation10,
+    Rotation11,
+    Rotation12,
+    Rotation20,
+    Rotation21,
+    Rotation22,
+    InverseSquaredSemiAxisA,
+    InverseSquaredSemiAxisB,
+    InverseSquaredSemiAxisC,
+    BoundingRadius,
+    Form,
+    Count
+};
+
+/**
+ * @brief A view of one catalog array, used in place from the mapped file.
+ */
+using ConstVectorXdMap = Eigen::Map<const Eigen::VectorXd, Eigen::AlignedMax>;
+
+/**
+ * @brief A read-only catalog of ellipsoids, memory-mapped from a binary catalog file.
+ */
+class EllipsoidCatalog
+{
+public:
+
+    /**
+     * @brief The format version written by this library, and the only version it reads.
+     */
+    static constexpr std::uint32_t version = 1;
+
+    /**
+     * @brief Alignment, in bytes, of the start of every array in the file.
+     */
+    static constexpr std::size_t alignment = 64;
+
+    /********** Loading **********/
+
+    /**
+     * @brief Maps a catalog file and validates its header and forms, closing any previously open catalog.
+     *
+     * Returns false if the file cannot be mapped, is not a catalog of this version, has arrays outside the file,
+     * or has a form byte that is not an EllipsoidForm value.
+     * Catalogs are little-endian, so they can only be used in place on little-endian hosts.
+     */
+    bool open(const std::string& path);
+
+    void close();
+
+    bool isOpen() const { return file.isOpen(); }
+
+    /********** Getters **********/
+
+    std::size_t getEllipsoidCount() const { return ellipsoid_count; }
+
+    /**
+     * @brief Returns the array of a, b or c semi-axes, for axis 0, 1 or 2.
+     */
+    ConstVectorXdMap getSemiAxes(int axis) const;
+
+    /**
+     * @brief Returns the array of x, y or z centre coordinates, for coordinate 0, 1 or 2.
+     */
+    ConstVectorXdMap getPositions(int coordinate) const;
+
+    /**
+     * @brief Returns the array of one entry of the rotation matrices.
+     */
+    ConstVectorXdMap getRotations(int row, int column) const;
+
+    /**
+     * @brief Returns the array of 1 / a^2, 1 / b^2 or 1 / c^2, for axis 0, 1 or 2.
+     */
+    ConstVectorXdMap getInverseSquaredSemiAxes(int axis) const;
+
+    /**
+     * @brief Returns the array of largest semi-axes, the radius of the bounding sphere about each centre.
+     */
+    ConstVectorXdMap getBoundingRadii() const;
+
+    EllipsoidForm getForm(std::size_t index) const { return static_cast<EllipsoidForm>(forms[index]); }
+
+    /**
+     * @brief Builds an Ellipsoid from one entry, using the stored form rather than recomputing it.
+     */
+    Ellipsoid getEllipsoid(std::size_t index) const;
+
+    /********** Queries **********/
+
+    /**
+     * @brief Returns true if the point lies on or inside the ellipsoid at index.
+     */
+    bool isInside(std::size_t index, const Eigen::Vector3d& point) const;
+
+    /**
+     * @brief Tests the point against every ellipsoid in the catalog, in parallel.
+     *
+     * The result is a view into storage allocated from the workspace, valid until the workspace is reset.
+     */
+    ArrayXbMap computeContainment(const Eigen::Vector3d& point, Workspace& workspace) const;
+
+    /********** Writing and Conversion **********/
+
+    /**
+     * @brief Writes a catalog file, computing the stored constants. Returns false if the file cannot be written.
+     */
+    static bool write(const std::string& path, const std::vector<Ellipsoid>& ellipsoids);
+
+    /**
+     * @brief Reads ellipsoids from a text file, appending them to ellipsoids.
+     *
+     * Each line holds a b c x y z, optionally followed by the nine rotation entries in row-major order. Blank
+     * lines and lines starting with # are skipped. Returns false, with line_number set to the offending line,
+     * if a line cannot be parsed.
+     */
+    static bool readText(const std::string& path, std::vector<Ellipsoid>& ellipsoids, std::size_t& line_number);
+
+private:
+
+    const double* getDoubleArray(CatalogArray array) const { return arrays[static_cast<std::size_t>(array)]; }
+
+    MappedFile file;
+    std::size_t ellipsoid_count = 0;
+
+    /**
+     * @brief Pointers into the mapped file for each double array, indexed by CatalogArray.
+     */
+    std::array<const double*, static_cast<std::size_t>(CatalogArray::Count)> arrays = {};
+
+    const std::uint8_t* forms = nullptr;
+};
+
+#endif // ELLIPSOID_CATALOG_HPP
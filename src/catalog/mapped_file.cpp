@@ -0,0 +1,133 @@
+#include "mapped_file.hpp"
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+    swap(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        close();
+        swap(other);
+    }
+    return *this;
+}
+
+void MappedFile::swap(MappedFile& other) noexcept
+{
+    std::swap(data, other.data);
+    std::swap(size, other.size);
+#ifdef _WIN32
+    std::swap(file_handle, other.file_handle);
+    std::swap(mapping_handle, other.mapping_handle);
+#endif
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string& path)
+{
+    close();
+
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) { return false; }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    data = static_cast<const std::byte*>(view);
+    size = static_cast<std::size_t>(file_size.QuadPart);
+    file_handle = file;
+    mapping_handle = mapping;
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (data != nullptr) { UnmapViewOfFile(data); }
+    if (mapping_handle != nullptr) { CloseHandle(mapping_handle); }
+    if (file_handle != nullptr) { CloseHandle(file_handle); }
+    data = nullptr;
+    size = 0;
+    file_handle = nullptr;
+    mapping_handle = nullptr;
+}
+
+#else
+
+bool MappedFile::open(const std::string& path)
+{
+    close();
+
+    int descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) { return false; }
+
+    struct stat file_status;
+    if (fstat(descriptor, &file_status) != 0 || file_status.st_size <= 0)
+    {
+        ::close(descriptor);
+        return false;
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    std::size_t file_size = static_cast<std::size_t>(file_status.st_size);
+    void* view = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    ::close(descriptor);
+    if (view == MAP_FAILED) { return false; }
+
+    data = static_cast<const std::byte*>(view);
+    size = file_size;
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (data != nullptr) { munmap(const_cast<std::byte*>(data), size); }
+    data = nullptr;
+    size = 0;
+}
+
+#endif
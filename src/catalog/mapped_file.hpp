@@ -0,0 +1,68 @@
+/**
+ * @file mapped_file.hpp
+ * @brief Defines the MappedFile class, a read-only memory mapping of a whole file.
+ *
+ * Mapping a file costs the same regardless of its size; pages are read from disk when first touched. The
+ * mapping is released when the MappedFile is closed or destroyed.
+ *
+ * Usage:
+ * @code
+ * MappedFile file;
+ * if (file.open("catalog.eorl"))
+ * {
+ *     const std::byte* data = file.getData();
+ * }
+ * @endcode
+ */
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief A read-only, move-only memory mapping of a file, using mmap on POSIX systems and a file mapping on Windows.
+ */
+class MappedFile
+{
+public:
+
+    /********** Constructors **********/
+
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /********** Mapping **********/
+
+    /**
+     * @brief Maps the whole file, closing any previous mapping. Returns false if the file cannot be mapped, or is empty.
+     */
+    bool open(const std::string& path);
+
+    void close();
+
+    /********** Getters **********/
+
+    bool isOpen() const { return data != nullptr; }
+    const std::byte* getData() const { return data; }
+    std::size_t getSize() const { return size; }
+
+private:
+
+    void swap(MappedFile& other) noexcept;
+
+    const std::byte* data = nullptr;
+    std::size_t size = 0;
+
+#ifdef _WIN32
+    void* file_handle = nullptr;
+    void* mapping_handle = nullptr;
+#endif
+};
+
+#endif // MAPPED_FILE_HPP
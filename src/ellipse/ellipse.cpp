@@ -16,11 +16,16 @@ Ellipse::Ellipse(const double& a, const double& b)
     orientation = Eigen::Matrix2d::Identity();
 }
 
-Eigen::Vector2d Ellipse::getPositionVector()
+Eigen::Vector2d Ellipse::getPositionVector() const
 {
     return position;
 }
 
+Eigen::Matrix2d Ellipse::getRotationMatrix() const
+{
+    return orientation;
+}
+
 void Ellipse::setCanonicalTransform()
 {
     setPositionVector();
@@ -24,6 +24,13 @@
 #include <memory>
 #include <Eigen/Core>
 
+class Workspace;
+
+/**
+ * @brief A 2xN matrix view into aligned storage owned by a Workspace, returned by batch queries.
+ */
+using Matrix2XdMap = Eigen::Map<Eigen::Matrix2Xd, Eigen::AlignedMax>;
+
 /**
  * @brief Represents a 2D ellipse with semi-principal axes, position and orientation.
  */
@@ -48,14 +55,15 @@ public:
 
     /********** Getters **********/
     
-    double getA() { return semi_axes[0]; }
-    double getB() { return semi_axes[1]; }
-    Eigen::Vector2d getPositionVector();
+    double getA() const { return semi_axes[0]; }
+    double getB() const { return semi_axes[1]; }
+    Eigen::Vector2d getPositionVector() const;
+    Eigen::Matrix2d getRotationMatrix() const;
 
     /********** Setters **********/
 
     void setA(double AxisA) { semi_axes[0] = AxisA; }
-    void setB(double AxisB) { semi_axes[0] = AxisB; }
+    void setB(double AxisB) { semi_axes[1] = AxisB; }
 
     void setCanonicalTransform();
     void setPositionVector();
@@ -103,6 +111,14 @@ public:
     Eigen::Vector2d computeClosestPerimeterPoint(const Eigen::Vector2d& query_point) const;
     Eigen::Vector2d computeClosestPerimeterPointCircle(const Eigen::Vector2d& query_point) const;
 
+    /**
+     * @brief Computes the closest perimeter point to each column of query_points.
+     *
+     * The result is a view into storage allocated from the workspace, valid until the workspace is reset.
+     */
+    Matrix2XdMap computeClosestPerimeterPoints(const Eigen::Ref<const Eigen::Matrix2Xd>& query_points, 
+                                               Workspace& workspace) const;
+
 private:
 
     /**
@@ -1,4 +1,5 @@
 #include "ellipse.hpp"
+#include "workspace.hpp"
 #include <cmath>
 
 
@@ -6,7 +7,7 @@ Eigen::Vector2d Ellipse::computeClosestPerimeterPoint(const Eigen::Vector2d &que
 {
     if (isCircle() == true)
     {
-        return computeClosestPerimeterPoint(query_point);
+        return computeClosestPerimeterPointCircle(query_point);
     }
     else
     {
@@ -34,3 +35,17 @@ Eigen::Vector2d Ellipse::computeClosestPerimeterPointCircle(const Eigen::Vector2
 
     return contact_point;
 }
+
+Matrix2XdMap Ellipse::computeClosestPerimeterPoints(const Eigen::Ref<const Eigen::Matrix2Xd>& query_points, 
+                                                    Workspace& workspace) const
+{
+    Eigen::Index point_count = query_points.cols();
+    Matrix2XdMap contact_points(workspace.allocate<double>(2 * point_count), 2, point_count);
+
+    for (Eigen::Index i = 0; i < point_count; i++)
+    {
+        contact_points.col(i) = computeClosestPerimeterPoint(query_points.col(i));
+    }
+
+    return contact_points;
+}
@@ -19,11 +19,25 @@ Ellipsoid::Ellipsoid(double a_axis, double b_axis, double c_axis)
     determineForm();
 }
 
-Eigen::Vector3d Ellipsoid::getPositionVector()
+Ellipsoid::Ellipsoid(const std::array<double, 3>& input_axes, const Eigen::Vector3d& input_position,
+                     const Eigen::Matrix3d& input_rotation, EllipsoidForm input_form)
+{
+    semi_axes = input_axes;
+    position = input_position;
+    orientation = input_rotation;
+    form = input_form;
+}
+
+Eigen::Vector3d Ellipsoid::getPositionVector() const
 {
     return position;
 }
 
+Eigen::Matrix3d Ellipsoid::getRotationMatrix() const
+{
+    return orientation;
+}
+
 void Ellipsoid::setA(double a_axis)
 {
     semi_axes[0] = a_axis;
@@ -45,6 +59,7 @@ void Ellipsoid::setC(double c_axis)
 void Ellipsoid::setSemiAxes(double a_axis, double b_axis, double c_axis)
 {
     semi_axes = {a_axis, b_axis, c_axis};
+    determineForm();
 }
 
 void Ellipsoid::setSemiAxes(std::array<double, 3> axes)
@@ -71,7 +86,7 @@ void Ellipsoid::setPositionVector(double x_coordinate, double y_coordinate, doub
 
 void Ellipsoid::setPositionVector(std::array<double, 3>& input_position)
 {
-    position = Eigen::Vector3d(position[0], position[1], position[2]);
+    position = Eigen::Vector3d(input_position[0], input_position[1], input_position[2]);
 }
 
 void Ellipsoid::setPositionVector(Eigen::Vector3d &input_position)
@@ -137,7 +152,7 @@ bool Ellipsoid::isTriaxial() const
 {
     return semi_axes[0] != semi_axes[1] && 
            semi_axes[1] != semi_axes[2] && 
-           semi_axes[0] != semi_axes[1];
+           semi_axes[0] != semi_axes[2];
 }
 
 bool Ellipsoid::isSpheroid() const
@@ -182,7 +197,7 @@ SpheroidAxes Ellipsoid::determineSpheroidAxes()
     spheroid_axes.repeated = -1.0;
     spheroid_axes.distinct = -1.0;
 
-    if (form != EllipsoidForm::Sphere)
+    if (!isSphere())
     {
         if (semi_axes[0] == semi_axes[1])
         {
@@ -24,6 +24,23 @@
 #include <memory>
 #include <Eigen/Core>
 
+class Workspace;
+
+/**
+ * @brief A 3xN matrix view into aligned storage owned by a Workspace, returned by batch queries.
+ */
+using Matrix3XdMap = Eigen::Map<Eigen::Matrix3Xd, Eigen::AlignedMax>;
+
+/**
+ * @brief A view of N values in aligned storage owned by a Workspace, returned by batch queries.
+ */
+using VectorXdMap = Eigen::Map<Eigen::VectorXd, Eigen::AlignedMax>;
+
+/**
+ * @brief A view of N flags in aligned storage owned by a Workspace, returned by batch queries.
+ */
+using ArrayXbMap = Eigen::Map<Eigen::Array<bool, Eigen::Dynamic, 1>, Eigen::AlignedMax>;
+
 enum class EllipsoidForm
 {
     Sphere,
@@ -62,15 +79,25 @@ public:
      */
     Ellipsoid(double a_axis, double b_axis, double c_axis);
 
+    /**
+     * @brief Parameterized constructor, with the full transform and a form already known to match the semi-axes.
+     *
+     * Used by loaders that store the form alongside the semi-axes, so that determineForm is not called again.
+     */
+    Ellipsoid(const std::array<double, 3>& input_axes, const Eigen::Vector3d& input_position,
+              const Eigen::Matrix3d& input_rotation, EllipsoidForm input_form);
+
     //Ellipsoid(const Vector3D& center, const Vector3D& radii, const Matrix3x3& orientation);
 
     /********** Getters **********/
     
-    double getA() { return semi_axes[0]; }
-    double getB() { return semi_axes[1]; }
-    double getC() { return semi_axes[2]; }
+    double getA() const { return semi_axes[0]; }
+    double getB() const { return semi_axes[1]; }
+    double getC() const { return semi_axes[2]; }
+    EllipsoidForm getForm() const { return form; }
 
-    Eigen::Vector3d getPositionVector();
+    Eigen::Vector3d getPositionVector() const;
+    Eigen::Matrix3d getRotationMatrix() const;
 
     /********** Setters **********/
 
@@ -132,8 +159,103 @@ public:
     /********** Distances and Intersections **********/
 
     Eigen::Vector3d computeClosestSurfacePoint(const Eigen::Vector3d& query_point) const;
+
+    /**
+     * @brief Computes the closest surface point of the canonical ellipsoid, with the query point given in the local frame.
+     */
+    Eigen::Vector3d computeClosestSurfacePointCanonical(const Eigen::Vector3d& local_query_point) const;
     Eigen::Vector3d computeClosestSurfacePointSphere(const Eigen::Vector3d& query_point) const;
 
+    /**
+     * @brief Computes the closest surface point to each column of query_points.
+     *
+     * The result is a view into storage allocated from the workspace, valid until the workspace is reset.
+     */
+    Matrix3XdMap computeClosestSurfacePoints(const Eigen::Ref<const Eigen::Matrix3Xd>& query_points, 
+                                             Workspace& workspace) const;
+
+    /**
+     * @brief Computes the shortest distance along the surface between two surface points.
+     *
+     * For many pairs on the same ellipsoid, use a GeodesicSolver to share the per-shape precomputation.
+     */
+    double computeGeodesicDistance(const Eigen::Vector3d& start_point, const Eigen::Vector3d& end_point) const;
+
+    /**
+     * @brief Computes where the line ray_origin + t * ray_direction enters and leaves the ellipsoid.
+     *
+     * Returns false if the line misses the ellipsoid. Otherwise entry <= exit are the parameters t of the two
+     * intersections, which may be negative.
+     */
+    bool computeLineIntersection(const Eigen::Vector3d& ray_origin, const Eigen::Vector3d& ray_direction,
+                                 double& entry, double& exit) const;
+
+    /********** Offset Surfaces **********/
+
+    /**
+     * @brief Computes the distance from the query point to the surface, negative inside the ellipsoid.
+     */
+    double computeSignedDistance(const Eigen::Vector3d& query_point) const;
+
+    /**
+     * @brief Computes the signed distance to the offset surface, the boundary of the ellipsoid inflated by
+     * offset_radius >= 0 (its Minkowski sum with a ball). As the ellipsoid is convex, this is exactly the signed
+     * distance to the ellipsoid minus offset_radius.
+     *
+     * All offset-surface queries throw std::invalid_argument if offset_radius is negative.
+     */
+    double computeOffsetDistance(const Eigen::Vector3d& query_point, double offset_radius) const;
+
+    /**
+     * @brief Returns true if the query point lies on or inside the offset surface.
+     */
+    bool isInsideOffsetSurface(const Eigen::Vector3d& query_point, double offset_radius) const;
+
+    /**
+     * @brief Computes the closest point on the offset surface, offset_radius along the normal from the closest
+     * point on the ellipsoid.
+     */
+    Eigen::Vector3d computeClosestOffsetSurfacePoint(const Eigen::Vector3d& query_point, double offset_radius) const;
+
+    /**
+     * @brief Computes the first intersection of a ray with the offset surface.
+     *
+     * Returns the parameter t >= 0 of the hit point ray_origin + t * ray_direction, zero if the origin is inside
+     * the offset surface, and infinity if the ray misses it.
+     */
+    double computeOffsetRayIntersection(const Eigen::Vector3d& ray_origin, const Eigen::Vector3d& ray_direction,
+                                        double offset_radius) const;
+
+    /**
+     * @brief Batched computeOffsetDistance over the columns of query_points, in parallel.
+     *
+     * The results of the batched offset queries are views into storage allocated from the workspace, valid until
+     * the workspace is reset.
+     */
+    VectorXdMap computeOffsetDistances(const Eigen::Ref<const Eigen::Matrix3Xd>& query_points, double offset_radius,
+                                       Workspace& workspace) const;
+
+    /**
+     * @brief Batched isInsideOffsetSurface over the columns of query_points, in parallel.
+     */
+    ArrayXbMap computeOffsetContainment(const Eigen::Ref<const Eigen::Matrix3Xd>& query_points, double offset_radius,
+                                        Workspace& workspace) const;
+
+    /**
+     * @brief Batched computeClosestOffsetSurfacePoint over the columns of query_points, in parallel.
+     */
+    Matrix3XdMap computeClosestOffsetSurfacePoints(const Eigen::Ref<const Eigen::Matrix3Xd>& query_points,
+                                                   double offset_radius, Workspace& workspace) const;
+
+    /**
+     * @brief Batched computeOffsetRayIntersection over the columns of ray_origins and ray_directions, in parallel.
+     *
+     * Throws std::invalid_argument if ray_origins and ray_directions have different numbers of columns.
+     */
+    VectorXdMap computeOffsetRayIntersections(const Eigen::Ref<const Eigen::Matrix3Xd>& ray_origins,
+                                              const Eigen::Ref<const Eigen::Matrix3Xd>& ray_directions,
+                                              double offset_radius, Workspace& workspace) const;
+
 
 private:
 
@@ -151,6 +273,9 @@ private:
 
     /**
      * @brief The orientation of the ellipsoid, represented as a 3x3 rotation matrix.
+     * 
+     * The columns are the directions of the a, b and c axes, so a point x in the ellipsoid frame lies at
+     * orientation * x + position.
      */
     Eigen::Matrix3d orientation;
 
@@ -1,18 +1,220 @@
 #include "ellipsoid.hpp"
+#include "newton_raphson.hpp"
+#include "workspace.hpp"
 #include <Eigen/Core>
+#include <algorithm>
 #include <cmath>
 
-Eigen::Vector3d Ellipsoid::computeClosestSurfacePoint(const Eigen::Vector3d& query_point) const
+namespace
 {
-    
+    /**
+     * @brief Root-finding data for the ellipse and ellipsoid closest point problems.
+     *
+     * Following Eberly, "Distance from a Point to an Ellipse, an Ellipsoid, or a Hyperellipsoid", the closest point
+     * is x_i = r_i * y_i / (s + r_i), where s is the unique root of F(s) = sum_i (r_i * z_i / (s + r_i))^2 - 1.
+     * The last ratio is 1, and the root is found in t = s + 1 so that the lower limit of the bracket, t = z_last,
+     * does not cancel to a pole when z_last is tiny.
+     */
+    struct ClosestPointRoot
+    {
+        int dimension;
+        double ratios[3];
+        double scaled_query[3];
+    };
+
+    double computeRoot(const ClosestPointRoot& root, double lower_limit, double upper_limit)
+    {
+        // Capture a single reference, so that std::function stores the lambdas without a heap allocation
+        auto function = [&root](double t)
+        {
+            double sum = -1.0;
+            for (int i = 0; i < root.dimension; i++)
+            {
+                double term = root.ratios[i] * root.scaled_query[i] / (t + (root.ratios[i] - 1.0));
+                sum += term * term;
+            }
+            return sum;
+        };
+        auto derivative = [&root](double t)
+        {
+            double sum = 0.0;
+            for (int i = 0; i < root.dimension; i++)
+            {
+                double denominator = t + (root.ratios[i] - 1.0);
+                double numerator = root.ratios[i] * root.scaled_query[i];
+                sum -= 2.0 * numerator * numerator / (denominator * denominator * denominator);
+            }
+            return sum;
+        };
+
+        // F is convex and decreasing on the bracket, so Newton-Raphson from the lower limit converges monotonically
+        return SafeNewtonRaphson(function, derivative, lower_limit, upper_limit, lower_limit);
+    }
+
+    /**
+     * @brief Closest point on an axis-aligned ellipse with e0 >= e1, for a query point with y0, y1 >= 0.
+     */
+    void computeClosestPointEllipse(double e0, double e1, double y0, double y1, double& x0, double& x1)
+    {
+        if (y1 > 0.0)
+        {
+            if (y0 > 0.0)
+            {
+                ClosestPointRoot root = {2, {(e0 / e1) * (e0 / e1), 1.0}, {y0 / e0, y1 / e1}};
+                double g = root.scaled_query[0] * root.scaled_query[0] + root.scaled_query[1] * root.scaled_query[1] - 1.0;
+                if (g != 0.0)
+                {
+                    double lower_limit = root.scaled_query[1];
+                    double upper_limit = (g < 0.0) ? 1.0 :
+                        std::hypot(root.ratios[0] * root.scaled_query[0], root.scaled_query[1]);
+                    double t = computeRoot(root, lower_limit, upper_limit);
+                    x0 = root.ratios[0] * y0 / (t + (root.ratios[0] - 1.0));
+                    x1 = y1 / t;
+                }
+                else
+                {
+                    x0 = y0;
+                    x1 = y1;
+                }
+            }
+            else
+            {
+                x0 = 0.0;
+                x1 = e1;
+            }
+        }
+        else
+        {
+            double numerator = e0 * y0;
+            double denominator = e0 * e0 - e1 * e1;
+            if (numerator < denominator)
+            {
+                double x_over_e = numerator / denominator;
+                x0 = e0 * x_over_e;
+                x1 = e1 * std::sqrt(1.0 - x_over_e * x_over_e);
+            }
+            else
+            {
+                x0 = e0;
+                x1 = 0.0;
+            }
+        }
+    }
 
+    /**
+     * @brief Closest point on an axis-aligned ellipsoid with e0 >= e1 >= e2, for a query point with y0, y1, y2 >= 0.
+     */
+    void computeClosestPointEllipsoid(const double e[3], const double y[3], double x[3])
+    {
+        if (y[2] > 0.0)
+        {
+            if (y[1] > 0.0)
+            {
+                if (y[0] > 0.0)
+                {
+                    ClosestPointRoot root = {3,
+                        {(e[0] / e[2]) * (e[0] / e[2]), (e[1] / e[2]) * (e[1] / e[2]), 1.0},
+                        {y[0] / e[0], y[1] / e[1], y[2] / e[2]}};
+                    const double* z = root.scaled_query;
+                    double g = z[0] * z[0] + z[1] * z[1] + z[2] * z[2] - 1.0;
+                    if (g != 0.0)
+                    {
+                        double lower_limit = z[2];
+                        double upper_limit = (g < 0.0) ? 1.0 : Eigen::Vector3d(root.ratios[0] * z[0],
+                                                                               root.ratios[1] * z[1],
+                                                                               z[2]).stableNorm();
+                        double t = computeRoot(root, lower_limit, upper_limit);
+                        for (int i = 0; i < 3; i++) { x[i] = root.ratios[i] * y[i] / (t + (root.ratios[i] - 1.0)); }
+                    }
+                    else
+                    {
+                        for (int i = 0; i < 3; i++) { x[i] = y[i]; }
+                    }
+                }
+                else
+                {
+                    x[0] = 0.0;
+                    computeClosestPointEllipse(e[1], e[2], y[1], y[2], x[1], x[2]);
+                }
+            }
+            else
+            {
+                x[1] = 0.0;
+                if (y[0] > 0.0)
+                {
+                    computeClosestPointEllipse(e[0], e[2], y[0], y[2], x[0], x[2]);
+                }
+                else
+                {
+                    x[0] = 0.0;
+                    x[2] = e[2];
+                }
+            }
+        }
+        else
+        {
+            // The closest point may lie off the z = 0 plane when the query is inside the ellipsoid
+            double denominator0 = e[0] * e[0] - e[2] * e[2];
+            double denominator1 = e[1] * e[1] - e[2] * e[2];
+            double numerator0 = e[0] * y[0];
+            double numerator1 = e[1] * y[1];
+            if (numerator0 < denominator0 && numerator1 < denominator1)
+            {
+                double x0_over_e0 = numerator0 / denominator0;
+                double x1_over_e1 = numerator1 / denominator1;
+                double discriminant = 1.0 - x0_over_e0 * x0_over_e0 - x1_over_e1 * x1_over_e1;
+                if (discriminant > 0.0)
+                {
+                    x[0] = e[0] * x0_over_e0;
+                    x[1] = e[1] * x1_over_e1;
+                    x[2] = e[2] * std::sqrt(discriminant);
+                    return;
+                }
+            }
+
+            x[2] = 0.0;
+            computeClosestPointEllipse(e[0], e[1], y[0], y[1], x[0], x[1]);
+        }
+    }
+}
+
+Eigen::Vector3d Ellipsoid::computeClosestSurfacePoint(const Eigen::Vector3d& query_point) const
+{
     if (form == EllipsoidForm::Sphere)
     {
         return computeClosestSurfacePointSphere(query_point);
     }
 
+    Eigen::Vector3d local_query = orientation.transpose() * (query_point - position);
+    Eigen::Vector3d local_contact = computeClosestSurfacePointCanonical(local_query);
+
+    return orientation * local_contact + position;
+}
+
+Eigen::Vector3d Ellipsoid::computeClosestSurfacePointCanonical(const Eigen::Vector3d& local_query_point) const
+{
+    // Sort the axes into decreasing order, and reflect the query point into the first octant
+    std::array<int, 3> order = {0, 1, 2};
+    std::sort(order.begin(), order.end(), [this](int i, int j) { return semi_axes[i] > semi_axes[j]; });
+
+    double sorted_axes[3];
+    double sorted_query[3];
+    double sorted_contact[3];
+    for (int i = 0; i < 3; i++)
+    {
+        sorted_axes[i] = semi_axes[order[i]];
+        sorted_query[i] = std::fabs(local_query_point[order[i]]);
+    }
+
+    computeClosestPointEllipsoid(sorted_axes, sorted_query, sorted_contact);
 
-    return Eigen::Vector3d(0.0, 0.0, 0.0);
+    Eigen::Vector3d local_contact;
+    for (int i = 0; i < 3; i++)
+    {
+        local_contact[order[i]] = std::copysign(sorted_contact[i], local_query_point[order[i]]);
+    }
+
+    return local_contact;
 }
 
 Eigen::Vector3d Ellipsoid::computeClosestSurfacePointSphere(const Eigen::Vector3d& query_point) const
@@ -32,3 +234,17 @@ Eigen::Vector3d Ellipsoid::computeClosestSurfacePointSphere(const Eigen::Vector3
 
     return contact_point;
 }
+
+Matrix3XdMap Ellipsoid::computeClosestSurfacePoints(const Eigen::Ref<const Eigen::Matrix3Xd>& query_points,
+                                                    Workspace& workspace) const
+{
+    Eigen::Index point_count = query_points.cols();
+    Matrix3XdMap contact_points(workspace.allocate<double>(3 * point_count), 3, point_count);
+
+    for (Eigen::Index i = 0; i < point_count; i++)
+    {
+        contact_points.col(i) = computeClosestSurfacePoint(query_points.col(i));
+    }
+
+    return contact_points;
+}
@@ -0,0 +1,236 @@
+#include "ellipsoid.hpp"
+#include "workspace.hpp"
+#include <Eigen/Core>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace
+{
+    /**
+     * @brief Throws if the offset radius is negative or not a number; every offset query assumes a ball of radius
+     * offset_radius >= 0.
+     */
+    void checkOffsetRadius(double offset_radius)
+    {
+        if (!(offset_radius >= 0.0)) { throw std::invalid_argument("Offset radius must be non-negative"); }
+    }
+
+    /**
+     * @brief Signed distance from the surface of the canonical ellipsoid, negative inside, together with the
+     * closest surface point and the outward unit normal there.
+     */
+    double computeSignedDistanceCanonical(const Ellipsoid& ellipsoid, const Eigen::Vector3d& local_query,
+                                          Eigen::Vector3d& local_contact, Eigen::Vector3d& local_normal)
+    {
+        const Eigen::Vector3d axes(ellipsoid.getA(), ellipsoid.getB(), ellipsoid.getC());
+
+        if (ellipsoid.getForm() == EllipsoidForm::Sphere)
+        {
+            double centre_distance = local_query.norm();
+            local_normal = centre_distance > 0.0 ? Eigen::Vector3d(local_query / centre_distance) : Eigen::Vector3d::UnitX();
+            local_contact = axes[0] * local_normal;
+            return centre_distance - axes[0];
+        }
+
+        local_contact = ellipsoid.computeClosestSurfacePointCanonical(local_query);
+        local_normal = local_contact.cwiseQuotient(axes.cwiseProduct(axes)).normalized();
+        double distance = (local_query - local_contact).norm();
+
+        return local_query.cwiseQuotient(axes).squaredNorm() < 1.0 ? -distance : distance;
+    }
+
+    /**
+     * @brief Returns the parameters at which the line o + s * u enters and leaves the axis-aligned ellipsoid with
+     * the given semi-axes, or false if it misses.
+     */
+    bool intersectLineEllipsoid(const Eigen::Vector3d& axes, const Eigen::Vector3d& origin,
+                                const Eigen::Vector3d& direction, double& entry, double& exit)
+    {
+        Eigen::Vector3d scaled_origin = origin.cwiseQuotient(axes);
+        Eigen::Vector3d scaled_direction = direction.cwiseQuotient(axes);
+        double quadratic = scaled_direction.squaredNorm();
+        double half_linear = scaled_origin.dot(scaled_direction);
+        double constant = scaled_origin.squaredNorm() - 1.0;
+
+        double discriminant = half_linear * half_linear - quadratic * constant;
+        if (quadratic == 0.0 || discriminant < 0.0) { return false; }
+
+        // Avoid cancellation by computing the root of larger magnitude first
+        double q = -(half_linear + std::copysign(std::sqrt(discriminant), half_linear));
+        double first = q / quadratic;
+        double second = (q != 0.0) ? constant / q : 0.0;
+        entry = std::min(first, second);
+        exit = std::max(first, second);
+
+        return true;
+    }
+}
+
+bool Ellipsoid::computeLineIntersection(const Eigen::Vector3d& ray_origin, const Eigen::Vector3d& ray_direction,
+                                        double& entry, double& exit) const
+{
+    Eigen::Vector3d origin = orientation.transpose() * (ray_origin - position);
+    Eigen::Vector3d direction = orientation.transpose() * ray_direction;
+
+    return intersectLineEllipsoid(Eigen::Vector3d(semi_axes[0], semi_axes[1], semi_axes[2]), origin, direction,
+                                  entry, exit);
+}
+
+double Ellipsoid::computeSignedDistance(const Eigen::Vector3d& query_point) const
+{
+    Eigen::Vector3d local_query = orientation.transpose() * (query_point - position);
+    Eigen::Vector3d local_contact;
+    Eigen::Vector3d local_normal;
+
+    return computeSignedDistanceCanonical(*this, local_query, local_contact, local_normal);
+}
+
+double Ellipsoid::computeOffsetDistance(const Eigen::Vector3d& query_point, double offset_radius) const
+{
+    checkOffsetRadius(offset_radius);
+    return computeSignedDistance(query_point) - offset_radius;
+}
+
+bool Ellipsoid::isInsideOffsetSurface(const Eigen::Vector3d& query_point, double offset_radius) const
+{
+    checkOffsetRadius(offset_radius);
+    Eigen::Vector3d local_query = orientation.transpose() * (query_point - position);
+    const Eigen::Vector3d axes(semi_axes[0], semi_axes[1], semi_axes[2]);
+
+    // The ellipsoid with semi-axes increased by the radius lies inside the offset surface, and the ellipsoid
+    // scaled by 1 + r / c_min contains it, so most points are decided without a closest point query
+    if (local_query.cwiseQuotient((axes.array() + offset_radius).matrix()).squaredNorm() <= 1.0) { return true; }
+    double outer_scale = 1.0 + offset_radius / axes.minCoeff();
+    if (local_query.cwiseQuotient(outer_scale * axes).squaredNorm() > 1.0) { return false; }
+
+    Eigen::Vector3d local_contact;
+    Eigen::Vector3d local_normal;
+    return computeSignedDistanceCanonical(*this, local_query, local_contact, local_normal) <= offset_radius;
+}
+
+Eigen::Vector3d Ellipsoid::computeClosestOffsetSurfacePoint(const Eigen::Vector3d& query_point, double offset_radius) const
+{
+    checkOffsetRadius(offset_radius);
+    Eigen::Vector3d local_query = orientation.transpose() * (query_point - position);
+    Eigen::Vector3d local_contact;
+    Eigen::Vector3d local_normal;
+    computeSignedDistanceCanonical(*this, local_query, local_contact, local_normal);
+
+    return orientation * (local_contact + offset_radius * local_normal) + position;
+}
+
+double Ellipsoid::computeOffsetRayIntersection(const Eigen::Vector3d& ray_origin, const Eigen::Vector3d& ray_direction,
+                                               double offset_radius) const
+{
+    checkOffsetRadius(offset_radius);
+    const double no_hit = std::numeric_limits<double>::infinity();
+    double direction_norm = ray_direction.norm();
+    if (direction_norm == 0.0) { return isInsideOffsetSurface(ray_origin, offset_radius) ? 0.0 : no_hit; }
+
+    // Work in the local frame, with distance s along a unit direction
+    Eigen::Vector3d origin = orientation.transpose() * (ray_origin - position);
+    Eigen::Vector3d direction = orientation.transpose() * ray_direction / direction_norm;
+    const Eigen::Vector3d axes(semi_axes[0], semi_axes[1], semi_axes[2]);
+
+    // Clip the ray to the scaled ellipsoid that contains the offset surface
+    double entry;
+    double exit;
+    double outer_scale = 1.0 + offset_radius / axes.minCoeff();
+    if (!intersectLineEllipsoid(outer_scale * axes, origin, direction, entry, exit) || exit < 0.0) { return no_hit; }
+
+    // The signed distance minus the radius is convex along the ray, with slope direction . normal. Newton-Raphson
+    // from before the first root therefore increases monotonically to it without overshooting, and a
+    // non-negative slope while still outside means the ray has passed the offset surface.
+    const double tolerance = 1.0e-12 * (axes.maxCoeff() + offset_radius);
+    double s = std::max(entry, 0.0);
+    Eigen::Vector3d local_contact;
+    Eigen::Vector3d local_normal;
+    double offset_distance = computeSignedDistanceCanonical(*this, origin + s * direction, local_contact, local_normal)
+        - offset_radius;
+    if (offset_distance <= 0.0) { return s / direction_norm; }
+
+    for (int iteration = 0; iteration < 100 && offset_distance > tolerance; iteration++)
+    {
+        double slope = direction.dot(local_normal);
+        if (slope >= 0.0) { return no_hit; }
+
+        s -= offset_distance / slope;
+        if (s > exit) { return no_hit; }
+
+        offset_distance = computeSignedDistanceCanonical(*this, origin + s * direction, local_contact, local_normal)
+            - offset_radius;
+    }
+
+    return offset_distance <= tolerance ? s / direction_norm : no_hit;
+}
+
+VectorXdMap Ellipsoid::computeOffsetDistances(const Eigen::Ref<const Eigen::Matrix3Xd>& query_points,
+                                              double offset_radius, Workspace& workspace) const
+{
+    checkOffsetRadius(offset_radius);
+    Eigen::Index point_count = query_points.cols();
+    VectorXdMap distances(workspace.allocate<double>(point_count), point_count);
+
+    #pragma omp parallel for schedule(static)
+    for (Eigen::Index i = 0; i < point_count; i++)
+    {
+        distances[i] = computeOffsetDistance(query_points.col(i), offset_radius);
+    }
+
+    return distances;
+}
+
+ArrayXbMap Ellipsoid::computeOffsetContainment(const Eigen::Ref<const Eigen::Matrix3Xd>& query_points,
+                                               double offset_radius, Workspace& workspace) const
+{
+    checkOffsetRadius(offset_radius);
+    Eigen::Index point_count = query_points.cols();
+    ArrayXbMap inside(workspace.allocate<bool>(point_count), point_count);
+
+    #pragma omp parallel for schedule(static)
+    for (Eigen::Index i = 0; i < point_count; i++)
+    {
+        inside[i] = isInsideOffsetSurface(query_points.col(i), offset_radius);
+    }
+
+    return inside;
+}
+
+Matrix3XdMap Ellipsoid::computeClosestOffsetSurfacePoints(const Eigen::Ref<const Eigen::Matrix3Xd>& query_points,
+                                                          double offset_radius, Workspace& workspace) const
+{
+    checkOffsetRadius(offset_radius);
+    Eigen::Index point_count = query_points.cols();
+    Matrix3XdMap contact_points(workspace.allocate<double>(3 * point_count), 3, point_count);
+
+    #pragma omp parallel for schedule(static)
+    for (Eigen::Index i = 0; i < point_count; i++)
+    {
+        contact_points.col(i) = computeClosestOffsetSurfacePoint(query_points.col(i), offset_radius);
+    }
+
+    return contact_points;
+}
+
+VectorXdMap Ellipsoid::computeOffsetRayIntersections(const Eigen::Ref<const Eigen::Matrix3Xd>& ray_origins,
+                                                     const Eigen::Ref<const Eigen::Matrix3Xd>& ray_directions,
+                                                     double offset_radius, Workspace& workspace) const
+{
+    checkOffsetRadius(offset_radius);
+    if (ray_directions.cols() != ray_origins.cols())
+    {
+        throw std::invalid_argument("Offset ray batches need the same number of ray origins and directions");
+    }
+    Eigen::Index ray_count = ray_origins.cols();
+    VectorXdMap hit_parameters(workspace.allocate<double>(ray_count), ray_count);
+
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (Eigen::Index i = 0; i < ray_count; i++)
+    {
+        hit_parameters[i] = computeOffsetRayIntersection(ray_origins.col(i), ray_directions.col(i), offset_radius);
+    }
+
+    return hit_parameters;
+}
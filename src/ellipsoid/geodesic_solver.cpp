@@ -0,0 +1,451 @@
+#include "geodesic_solver.hpp"
+#include "newton_raphson.hpp"
+#include "workspace.hpp"
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <Eigen/QR>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+    constexpr double pi = 3.14159265358979323846;
+
+    /**
+     * @brief Evaluates sum_l coefficients[l - 1] * sin(2 l sigma) by Clenshaw summation.
+     */
+    template <std::size_t count>
+    double sumSineSeries(const std::array<double, count>& coefficients, double sigma)
+    {
+        double x = 2.0 * std::cos(2.0 * sigma);
+        double b_next = 0.0;
+        double b_next_next = 0.0;
+        for (std::size_t l = count; l-- > 0;)
+        {
+            double b = coefficients[l] + x * b_next - b_next_next;
+            b_next_next = b_next;
+            b_next = b;
+        }
+        return b_next * std::sin(2.0 * sigma);
+    }
+
+    /**
+     * @brief Moves a point in the ellipsoid frame onto the surface, along the normal of the level set through it.
+     */
+    Eigen::Vector3d projectToSurface(Eigen::Vector3d point, const Eigen::Vector3d& inverse_axes_squared)
+    {
+        for (int iteration = 0; iteration < 3; iteration++)
+        {
+            Eigen::Vector3d gradient = point.cwiseProduct(inverse_axes_squared);
+            double level = point.dot(gradient) - 1.0;
+            point -= (0.5 * level / gradient.squaredNorm()) * gradient;
+        }
+        return point;
+    }
+
+    /**
+     * @brief Integrates the unit-speed geodesic equation x'' = -(x'^T H x' / |g|^2) g with RK4, where g = H x.
+     */
+    void integrateGeodesic(Eigen::Vector3d& point, Eigen::Vector3d& velocity, double length, int steps,
+                           const Eigen::Vector3d& inverse_axes_squared)
+    {
+        auto acceleration = [&inverse_axes_squared](const Eigen::Vector3d& x, const Eigen::Vector3d& v)
+        {
+            Eigen::Vector3d gradient = x.cwiseProduct(inverse_axes_squared);
+            double curvature = v.cwiseProduct(inverse_axes_squared).dot(v);
+            return Eigen::Vector3d(-(curvature / gradient.squaredNorm()) * gradient);
+        };
+
+        double h = length / steps;
+        for (int step = 0; step < steps; step++)
+        {
+            Eigen::Vector3d k1_x = velocity;
+            Eigen::Vector3d k1_v = acceleration(point, velocity);
+            Eigen::Vector3d k2_x = velocity + 0.5 * h * k1_v;
+            Eigen::Vector3d k2_v = acceleration(point + 0.5 * h * k1_x, k2_x);
+            Eigen::Vector3d k3_x = velocity + 0.5 * h * k2_v;
+            Eigen::Vector3d k3_v = acceleration(point + 0.5 * h * k2_x, k3_x);
+            Eigen::Vector3d k4_x = velocity + h * k3_v;
+            Eigen::Vector3d k4_v = acceleration(point + h * k3_x, k4_x);
+            point += (h / 6.0) * (k1_x + 2.0 * k2_x + 2.0 * k3_x + k4_x);
+            velocity += (h / 6.0) * (k1_v + 2.0 * k2_v + 2.0 * k3_v + k4_v);
+        }
+    }
+}
+
+GeodesicSolver::GeodesicSolver(const Ellipsoid& ellipsoid)
+{
+    semi_axes = Eigen::Vector3d(ellipsoid.getA(), ellipsoid.getB(), ellipsoid.getC());
+    orientation = ellipsoid.getRotationMatrix();
+    position = ellipsoid.getPositionVector();
+    form = ellipsoid.getForm();
+
+    has_spheroid_series = false;
+    spheroid_axis_order = {0, 1, 2};
+    equatorial_radius = semi_axes[0];
+    polar_radius = semi_axes[0];
+    flattening = 0.0;
+    second_eccentricity_squared = 0.0;
+    a3_coefficients.fill(0.0);
+    for (std::array<double, 6>& coefficients : c3_coefficients) { coefficients.fill(0.0); }
+
+    if (form != EllipsoidForm::Oblate && form != EllipsoidForm::Prolate) { return; }
+
+    if (semi_axes[0] == semi_axes[1]) { spheroid_axis_order = {0, 1, 2}; }
+    else if (semi_axes[0] == semi_axes[2]) { spheroid_axis_order = {2, 0, 1}; }
+    else { spheroid_axis_order = {1, 2, 0}; }
+
+    equatorial_radius = semi_axes[spheroid_axis_order[0]];
+    polar_radius = semi_axes[spheroid_axis_order[2]];
+    flattening = (equatorial_radius - polar_radius) / equatorial_radius;
+    second_eccentricity_squared = flattening * (2.0 - flattening) / ((1.0 - flattening) * (1.0 - flattening));
+
+    // The sixth-order series are accurate to round-off for |f| <= 0.01, with f < 0 for prolate spheroids. The
+    // margin keeps spheroids at exactly 1% flattening, such as a = 1 and c = 0.99, despite rounding in f.
+    has_spheroid_series = std::fabs(flattening) <= 0.01 + 1.0e-12;
+
+    double n = flattening / (2.0 - flattening);
+    double n2 = n * n;
+    a3_coefficients = {1.0,
+                       -(1.0 / 2.0 - n / 2.0),
+                       -(1.0 / 4.0 + n / 8.0 - 3.0 * n2 / 8.0),
+                       -(1.0 / 16.0 + 3.0 * n / 16.0 + n2 / 16.0),
+                       -(3.0 / 64.0 + n / 32.0),
+                       -3.0 / 128.0};
+    c3_coefficients[0] = {0.0, 1.0 / 4.0 - n / 4.0, 1.0 / 8.0 - n2 / 8.0, 3.0 / 64.0 + 3.0 * n / 64.0 - n2 / 64.0,
+                          5.0 / 128.0 + n / 64.0, 3.0 / 128.0};
+    c3_coefficients[1] = {0.0, 0.0, 1.0 / 16.0 - 3.0 * n / 32.0 + n2 / 32.0, 3.0 / 64.0 - n / 32.0 - 3.0 * n2 / 64.0,
+                          3.0 / 128.0 + n / 128.0, 5.0 / 256.0};
+    c3_coefficients[2] = {0.0, 0.0, 0.0, 5.0 / 192.0 - 3.0 * n / 64.0 + 5.0 * n2 / 192.0, 3.0 / 128.0 - 5.0 * n / 192.0,
+                          7.0 / 512.0};
+    c3_coefficients[3] = {0.0, 0.0, 0.0, 0.0, 7.0 / 512.0 - 7.0 * n / 256.0, 7.0 / 512.0};
+    c3_coefficients[4] = {0.0, 0.0, 0.0, 0.0, 0.0, 21.0 / 2560.0};
+}
+
+double GeodesicSolver::computeDistance(const Eigen::Vector3d& start_point, const Eigen::Vector3d& end_point,
+                                       GeodesicMethod method) const
+{
+    Eigen::Vector3d start_local = orientation.transpose() * (start_point - position);
+    Eigen::Vector3d end_local = orientation.transpose() * (end_point - position);
+
+    if (method != GeodesicMethod::Numerical)
+    {
+        if (form == EllipsoidForm::Sphere) { return computeDistanceSphere(start_local, end_local); }
+        if (has_spheroid_series)
+        {
+            double distance = computeDistanceSpheroid(start_local, end_local);
+
+            // On a prolate spheroid, lambda12 is not monotonic in alpha1 within about pi |f| of the antipode, so the
+            // azimuth found may belong to a longer geodesic. Both methods give lengths of geodesics, so keep the shorter.
+            Eigen::Vector3d start_unit = start_local.cwiseQuotient(semi_axes).normalized();
+            Eigen::Vector3d end_unit = end_local.cwiseQuotient(semi_axes).normalized();
+            if (flattening < 0.0 && start_unit.dot(end_unit) < -std::cos(2.0 * pi * flattening))
+            {
+                distance = std::min(distance, computeDistanceNumerical(start_local, end_local));
+            }
+
+            return distance;
+        }
+    }
+
+    return computeDistanceNumerical(start_local, end_local);
+}
+
+VectorXdMap GeodesicSolver::computeDistances(const Eigen::Ref<const Eigen::Matrix3Xd>& start_points,
+                                             const Eigen::Ref<const Eigen::Matrix3Xd>& end_points,
+                                             Workspace& workspace, GeodesicMethod method) const
+{
+    if (start_points.cols() != end_points.cols())
+    {
+        throw std::invalid_argument("Geodesic batches need the same number of start and end points");
+    }
+    Eigen::Index pair_count = start_points.cols();
+    VectorXdMap distances(workspace.allocate<double>(pair_count), pair_count);
+
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (Eigen::Index i = 0; i < pair_count; i++)
+    {
+        distances[i] = computeDistance(start_points.col(i), end_points.col(i), method);
+    }
+
+    return distances;
+}
+
+double GeodesicSolver::computeDistanceSphere(const Eigen::Vector3d& start_local, const Eigen::Vector3d& end_local) const
+{
+    return semi_axes[0] * std::atan2(start_local.cross(end_local).norm(), start_local.dot(end_local));
+}
+
+double GeodesicSolver::computeDistanceSpheroid(const Eigen::Vector3d& start_local, const Eigen::Vector3d& end_local) const
+{
+    int x_index = spheroid_axis_order[0];
+    int y_index = spheroid_axis_order[1];
+    int z_index = spheroid_axis_order[2];
+
+    // Reduced latitudes and longitudes of the two points
+    double start_latitude = std::atan2(start_local[z_index] / polar_radius,
+                                       std::hypot(start_local[x_index], start_local[y_index]) / equatorial_radius);
+    double end_latitude = std::atan2(end_local[z_index] / polar_radius,
+                                     std::hypot(end_local[x_index], end_local[y_index]) / equatorial_radius);
+    double longitude_difference = std::fabs(std::remainder(
+        std::atan2(end_local[y_index], end_local[x_index]) - std::atan2(start_local[y_index], start_local[x_index]),
+        2.0 * pi));
+
+    // Put the points in canonical position: |beta1| >= |beta2|, beta1 <= 0 and lambda12 in [0, pi]
+    if (std::fabs(start_latitude) < std::fabs(end_latitude)) { std::swap(start_latitude, end_latitude); }
+    if (start_latitude > 0.0)
+    {
+        start_latitude = -start_latitude;
+        end_latitude = -end_latitude;
+    }
+
+    // lambda12 increases monotonically from 0 (northward meridian) to pi (southward meridian) with alpha1
+    double lower_azimuth = 0.0;
+
+    // Both points on the equator: the equator is shortest unless the points are nearly antipodal, in which case
+    // the geodesic leaves the equator heading south, with alpha1 in (pi/2, pi]
+    if (start_latitude > -1.0e-12)
+    {
+        if (longitude_difference <= (1.0 - flattening) * pi) { return equatorial_radius * longitude_difference; }
+        start_latitude = -0.0;
+        end_latitude = 0.0;
+        lower_azimuth = 0.5 * pi;
+    }
+
+    double arc_longitude;
+    double arc_distance;
+
+    computeSpheroidArc(start_latitude, end_latitude, pi, arc_longitude, arc_distance);
+    if (longitude_difference >= arc_longitude) { return arc_distance; }
+    if (longitude_difference <= 0.0)
+    {
+        computeSpheroidArc(start_latitude, end_latitude, 0.0, arc_longitude, arc_distance);
+        return arc_distance;
+    }
+
+    struct AzimuthRoot
+    {
+        const GeodesicSolver* solver;
+        double start_latitude;
+        double end_latitude;
+        double longitude_difference;
+    } root = {this, start_latitude, end_latitude, longitude_difference};
+
+    auto function = [&root](double azimuth)
+    {
+        double longitude;
+        double distance;
+        root.solver->computeSpheroidArc(root.start_latitude, root.end_latitude, azimuth, longitude, distance);
+        return longitude - root.longitude_difference;
+    };
+    auto derivative = [&root](double azimuth)
+    {
+        // Spherical estimate of d(lambda12)/d(alpha1) = m12 / (cos(alpha2) cos(beta2)), with m12 = sin(sigma12)
+        double start_cos = std::cos(root.start_latitude);
+        double end_cos = std::cos(root.end_latitude);
+        double azimuth_cos = std::cos(azimuth);
+        double end_azimuth_cos = std::sqrt(std::max(0.0, azimuth_cos * azimuth_cos * start_cos * start_cos +
+                                                         (end_cos - start_cos) * (end_cos + start_cos))) / end_cos;
+        double start_arc = std::atan2(std::sin(root.start_latitude), azimuth_cos * start_cos);
+        double end_arc = std::atan2(std::sin(root.end_latitude), end_azimuth_cos * end_cos);
+        return std::sin(end_arc - start_arc) / std::max(end_azimuth_cos * end_cos, 1.0e-12);
+    };
+
+    // Initial guess from the great circle on the auxiliary sphere
+    double initial_azimuth = std::atan2(std::cos(end_latitude) * std::sin(longitude_difference),
+                                        std::cos(start_latitude) * std::sin(end_latitude) -
+                                        std::sin(start_latitude) * std::cos(end_latitude) * std::cos(longitude_difference));
+    initial_azimuth = std::clamp(initial_azimuth, lower_azimuth, pi);
+
+    double azimuth = SafeNewtonRaphson(function, derivative, lower_azimuth, pi, initial_azimuth);
+    computeSpheroidArc(start_latitude, end_latitude, azimuth, arc_longitude, arc_distance);
+
+    return arc_distance;
+}
+
+void GeodesicSolver::computeSpheroidArc(double start_latitude, double end_latitude, double start_azimuth,
+                                        double& longitude_difference, double& distance) const
+{
+    double start_sin = std::sin(start_latitude);
+    double start_cos = std::cos(start_latitude);
+    double end_sin = std::sin(end_latitude);
+    double end_cos = std::cos(end_latitude);
+    double azimuth_sin = std::sin(start_azimuth);
+    double azimuth_cos = std::cos(start_azimuth);
+
+    // Azimuth at the equator crossing (alpha0), and at the second point, from Clairaut's relation
+    double equatorial_azimuth_sin = azimuth_sin * start_cos;
+    double end_azimuth_cos_squared = (azimuth_cos * start_cos) * (azimuth_cos * start_cos) +
+        (start_cos < -start_sin ? (end_cos - start_cos) * (end_cos + start_cos)
+                                : (start_sin - end_sin) * (start_sin + end_sin));
+    double end_azimuth_cos = std::sqrt(std::max(0.0, end_azimuth_cos_squared)) / end_cos;
+
+    // Arc lengths and longitudes on the auxiliary sphere, measured from the equator crossing
+    double start_arc = std::atan2(start_sin, azimuth_cos * start_cos);
+    double end_arc = std::atan2(end_sin, end_azimuth_cos * end_cos);
+    double start_omega = std::atan2(equatorial_azimuth_sin * start_sin, azimuth_cos * start_cos);
+    double end_omega = std::atan2(equatorial_azimuth_sin * end_sin, end_azimuth_cos * end_cos);
+
+    double k_squared = second_eccentricity_squared * (1.0 - equatorial_azimuth_sin * equatorial_azimuth_sin);
+    double root = std::sqrt(1.0 + k_squared);
+    double epsilon = k_squared / ((root + 1.0) * (root + 1.0));
+    double eps2 = epsilon * epsilon;
+    double eps3 = eps2 * epsilon;
+    double eps4 = eps2 * eps2;
+    double eps5 = eps4 * epsilon;
+    double eps6 = eps3 * eps3;
+
+    // Distance integral I1 = A1 (sigma + sum C1l sin(2 l sigma))
+    double a1 = (1.0 + eps2 / 4.0 + eps4 / 64.0 + eps6 / 256.0) / (1.0 - epsilon);
+    std::array<double, 6> c1 = {-epsilon / 2.0 + 3.0 * eps3 / 16.0 - eps5 / 32.0,
+                                -eps2 / 16.0 + eps4 / 32.0 - 9.0 * eps6 / 2048.0,
+                                -eps3 / 48.0 + 3.0 * eps5 / 256.0,
+                                -5.0 * eps4 / 512.0 + 3.0 * eps6 / 1024.0,
+                                -7.0 * eps5 / 1280.0,
+                                -7.0 * eps6 / 2048.0};
+
+    // Longitude integral I3 = A3 (sigma + sum C3l sin(2 l sigma))
+    std::array<double, 6> powers = {1.0, epsilon, eps2, eps3, eps4, eps5};
+    double a3 = 0.0;
+    std::array<double, 5> c3 = {0.0, 0.0, 0.0, 0.0, 0.0};
+    for (int m = 0; m < 6; m++)
+    {
+        a3 += a3_coefficients[m] * powers[m];
+        for (int l = 0; l < 5; l++) { c3[l] += c3_coefficients[l][m] * powers[m]; }
+    }
+
+    double arc = end_arc - start_arc;
+    double distance_integral = a1 * (arc + sumSineSeries(c1, end_arc) - sumSineSeries(c1, start_arc));
+    double longitude_integral = a3 * (arc + sumSineSeries(c3, end_arc) - sumSineSeries(c3, start_arc));
+
+    longitude_difference = end_omega - start_omega - flattening * equatorial_azimuth_sin * longitude_integral;
+    distance = polar_radius * distance_integral;
+}
+
+double GeodesicSolver::computeDistanceNumerical(const Eigen::Vector3d& start_local, const Eigen::Vector3d& end_local) const
+{
+    double distance = computeDistanceShooting(start_local, end_local);
+
+    // Far apart, the relaxation may settle on a different local geodesic from each end, so keep the shorter
+    if (start_local.cwiseQuotient(semi_axes).dot(end_local.cwiseQuotient(semi_axes)) < 0.0)
+    {
+        distance = std::min(distance, computeDistanceShooting(end_local, start_local));
+    }
+
+    return distance;
+}
+
+double GeodesicSolver::computeDistanceShooting(const Eigen::Vector3d& start_local, const Eigen::Vector3d& end_local) const
+{
+    const Eigen::Vector3d inverse_axes_squared = semi_axes.cwiseProduct(semi_axes).cwiseInverse();
+    const double max_axis = semi_axes.maxCoeff();
+    const double min_axis = semi_axes.minCoeff();
+
+    Eigen::Vector3d start_unit = start_local.cwiseQuotient(semi_axes).normalized();
+    Eigen::Vector3d end_unit = end_local.cwiseQuotient(semi_axes).normalized();
+    Eigen::Vector3d start = semi_axes.cwiseProduct(start_unit);
+    Eigen::Vector3d end = semi_axes.cwiseProduct(end_unit);
+    if ((end - start).norm() <= 1.0e-15 * max_axis) { return 0.0; }
+
+    // Start from the image of the great circle between the points on the unit sphere
+    double angle = std::atan2(start_unit.cross(end_unit).norm(), start_unit.dot(end_unit));
+    Eigen::Vector3d perpendicular = end_unit - start_unit.dot(end_unit) * start_unit;
+    if (perpendicular.norm() < 1.0e-12)
+    {
+        perpendicular = start_unit.unitOrthogonal();
+    }
+    perpendicular.normalize();
+
+    constexpr int max_segments = 32;
+    std::array<Eigen::Vector3d, max_segments + 1> path;
+    int segments = 4;
+    for (int k = 0; k <= segments; k++)
+    {
+        double fraction = angle * k / segments;
+        path[k] = semi_axes.cwiseProduct(std::cos(fraction) * start_unit + std::sin(fraction) * perpendicular);
+    }
+    path[0] = start;
+    path[segments] = end;
+
+    // Relax the polyline towards a discrete shortest path by successive over-relaxation, then refine it
+    while (true)
+    {
+        double relaxation = 2.0 / (1.0 + std::sin(pi / segments));
+        double tolerance = 1.0e-9 * max_axis;
+        for (int sweep = 0; sweep < 100 * segments; sweep++)
+        {
+            double max_move = 0.0;
+            for (int k = 1; k < segments; k++)
+            {
+                Eigen::Vector3d midpoint = 0.5 * (path[k - 1] + path[k + 1]);
+                Eigen::Vector3d moved = projectToSurface(path[k] + relaxation * (midpoint - path[k]), inverse_axes_squared);
+                max_move = std::max(max_move, (moved - path[k]).norm());
+                path[k] = moved;
+            }
+            if (max_move < tolerance) { break; }
+        }
+
+        if (segments == max_segments) { break; }
+
+        for (int k = segments; k >= 0; k--) { path[2 * k] = path[k]; }
+        for (int k = 1; k < 2 * segments; k += 2)
+        {
+            path[k] = projectToSurface(0.5 * (path[k - 1] + path[k + 1]), inverse_axes_squared);
+        }
+        segments *= 2;
+    }
+
+    double polyline_length = 0.0;
+    for (int k = 0; k < segments; k++) { polyline_length += (path[k + 1] - path[k]).norm(); }
+
+    // Shoot along the geodesic equation, solving for the initial direction and length that reach the end point
+    Eigen::Vector3d normal = start.cwiseProduct(inverse_axes_squared).normalized();
+    Eigen::Vector3d first_direction = path[1] - path[0];
+    first_direction = (first_direction - normal.dot(first_direction) * normal).normalized();
+    Eigen::Vector3d second_direction = normal.cross(first_direction);
+
+    double min_radius_of_curvature = min_axis * min_axis / max_axis;
+    auto shoot = [&](double direction_angle, double length, Eigen::Vector3d& velocity)
+    {
+        Eigen::Vector3d point = start;
+        velocity = std::cos(direction_angle) * first_direction + std::sin(direction_angle) * second_direction;
+        int steps = static_cast<int>(std::clamp(std::ceil(length / (0.002 * min_radius_of_curvature)), 100.0, 200000.0));
+        integrateGeodesic(point, velocity, length, steps, inverse_axes_squared);
+        return point;
+    };
+
+    double direction_angle = 0.0;
+    double length = polyline_length;
+    Eigen::Vector3d velocity;
+    Eigen::Vector3d residual = shoot(direction_angle, length, velocity) - end;
+    double residual_norm = residual.norm();
+
+    const double angle_step = 1.0e-7;
+    for (int iteration = 0; iteration < 20 && residual_norm > 1.0e-12 * max_axis; iteration++)
+    {
+        Eigen::Vector3d perturbed_velocity;
+        Eigen::Matrix<double, 3, 2> jacobian;
+        jacobian.col(0) = (shoot(direction_angle + angle_step, length, perturbed_velocity) - end - residual) / angle_step;
+        jacobian.col(1) = velocity;
+
+        Eigen::Vector2d step = jacobian.colPivHouseholderQr().solve(-residual);
+        Eigen::Vector3d candidate_velocity;
+        Eigen::Vector3d candidate_residual = shoot(direction_angle + step[0], length + step[1], candidate_velocity) - end;
+        if (candidate_residual.norm() >= residual_norm) { break; }
+
+        direction_angle += step[0];
+        length += step[1];
+        velocity = candidate_velocity;
+        residual = candidate_residual;
+        residual_norm = residual.norm();
+    }
+
+    // If shooting did not reach the end point, the relaxed polyline is the better estimate
+    return residual_norm < 1.0e-6 * max_axis ? length : polyline_length;
+}
+
+double Ellipsoid::computeGeodesicDistance(const Eigen::Vector3d& start_point, const Eigen::Vector3d& end_point) const
+{
+    return GeodesicSolver(*this).computeDistance(start_point, end_point);
+}
@@ -0,0 +1,129 @@
+/**
+ * @file geodesic_solver.hpp
+ * @brief Defines the GeodesicSolver class, which computes shortest-path distances along the surface of an Ellipsoid.
+ *
+ * Two methods are provided. For spheres, and for oblate and prolate spheroids with |flattening| up to 0.01
+ * (planetary body models), the distance is computed from the auxiliary-sphere series of Karney, "Algorithms for
+ * geodesics" (2013), with the azimuth at the first point found by a safeguarded Newton iteration. The series are
+ * written in terms of the signed flattening, which is negative for prolate spheroids. For all other ellipsoids, a
+ * discrete shortest path is relaxed on the surface and then refined by shooting along the geodesic equation.
+ *
+ * Everything that depends only on the ellipsoid (transform, form, flattening and series coefficients) is
+ * computed once in the constructor, so that batches of point pairs on one ellipsoid share it.
+ *
+ * Usage:
+ * @code
+ * GeodesicSolver solver(ellipsoid);
+ * double distance = solver.computeDistance(start_point, end_point);
+ * Eigen::Map<Eigen::VectorXd, Eigen::AlignedMax> distances = solver.computeDistances(starts, ends, workspace);
+ * @endcode
+ */
+#ifndef GEODESIC_SOLVER_HPP
+#define GEODESIC_SOLVER_HPP
+
+#include "ellipsoid.hpp"
+#include <array>
+#include <Eigen/Core>
+
+enum class GeodesicMethod
+{
+    Automatic,
+    SpheroidSeries,
+    Numerical
+};
+
+/**
+ * @brief Computes geodesic distances between points on the surface of one Ellipsoid.
+ */
+class GeodesicSolver
+{
+public:
+
+    /********** Constructors **********/
+
+    /**
+     * @brief Precomputes the per-shape constants for an ellipsoid.
+     */
+    explicit GeodesicSolver(const Ellipsoid& ellipsoid);
+
+    /********** Queries **********/
+
+    /**
+     * @brief Returns true if the spheroid series applies to this ellipsoid.
+     */
+    bool hasSpheroidSeries() const { return has_spheroid_series; }
+
+    /**
+     * @brief Computes the geodesic distance between two points on the surface.
+     *
+     * The points are given in world coordinates, and are moved onto the surface along the radial direction of
+     * the unit sphere that the ellipsoid is mapped from. Automatic uses the spheroid series where it applies,
+     * and the numerical method otherwise. Requesting SpheroidSeries for an ellipsoid without it also falls back
+     * to the numerical method. On a prolate spheroid, nearly antipodal points are also solved numerically, and
+     * the shorter of the two distances is kept.
+     *
+     * The numerical method converges to the shortest path near the image of a great circle on the unit sphere,
+     * solving from both ends for distant points and keeping the shorter. For nearly antipodal points on a
+     * triaxial ellipsoid this may still be a longer, locally shortest, geodesic.
+     */
+    double computeDistance(const Eigen::Vector3d& start_point, const Eigen::Vector3d& end_point,
+                           GeodesicMethod method = GeodesicMethod::Automatic) const;
+
+    /**
+     * @brief Computes the geodesic distance between each pair of columns of start_points and end_points, in parallel.
+     *
+     * The result is a view into storage allocated from the workspace, valid until the workspace is reset. Throws
+     * std::invalid_argument if start_points and end_points have different numbers of columns.
+     */
+    VectorXdMap computeDistances(const Eigen::Ref<const Eigen::Matrix3Xd>& start_points,
+                                 const Eigen::Ref<const Eigen::Matrix3Xd>& end_points, Workspace& workspace,
+                                 GeodesicMethod method = GeodesicMethod::Automatic) const;
+
+private:
+
+    double computeDistanceSphere(const Eigen::Vector3d& start_local, const Eigen::Vector3d& end_local) const;
+    double computeDistanceSpheroid(const Eigen::Vector3d& start_local, const Eigen::Vector3d& end_local) const;
+    double computeDistanceNumerical(const Eigen::Vector3d& start_local, const Eigen::Vector3d& end_local) const;
+
+    /**
+     * @brief Relaxes a discrete shortest path from the start point to the end point, then refines it by shooting.
+     */
+    double computeDistanceShooting(const Eigen::Vector3d& start_local, const Eigen::Vector3d& end_local) const;
+
+    /**
+     * @brief Returns the longitude difference and distance on the spheroid for a given azimuth at the first point.
+     */
+    void computeSpheroidArc(double start_latitude, double end_latitude, double start_azimuth,
+                            double& longitude_difference, double& distance) const;
+
+    Eigen::Vector3d semi_axes;
+    Eigen::Matrix3d orientation;
+    Eigen::Vector3d position;
+    EllipsoidForm form;
+
+    /********** Spheroid Constants **********/
+
+    bool has_spheroid_series;
+
+    /**
+     * @brief The index of the symmetry axis of a spheroid, and the indices of its two equatorial axes.
+     */
+    std::array<int, 3> spheroid_axis_order;
+
+    double equatorial_radius;
+    double polar_radius;
+    double flattening;
+    double second_eccentricity_squared;
+
+    /**
+     * @brief Coefficients of A3 as a polynomial in epsilon, with the dependence on the third flattening folded in.
+     */
+    std::array<double, 6> a3_coefficients;
+
+    /**
+     * @brief Coefficients of C3l, l = 1..5, as polynomials in epsilon, with the third flattening folded in.
+     */
+    std::array<std::array<double, 6>, 5> c3_coefficients;
+};
+
+#endif // GEODESIC_SOLVER_HPP
@@ -0,0 +1,436 @@
+#include "moving_ellipsoid.hpp"
+#include "workspace.hpp"
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace
+{
+    const double no_contact = std::numeric_limits<double>::infinity();
+
+    /**
+     * @brief Smallest advancement step, as a fraction of the timestep. Near a grazing approach or a shallow contact
+     * the conservative steps shrink with the separation and would stall short of the contact, so shorter steps are
+     * replaced by steps of this length and the contact is found by bracketing instead.
+     */
+    constexpr double min_advancement = 1.0e-4;
+
+    /**
+     * @brief Returns a time in [lower, upper] within contact_distance / max_speed of the first time at which the
+     * separation falls to the contact distance, given that it is above it at lower and not at upper. The lower end
+     * of the final bracket is returned, so the time is not later than the contact.
+     */
+    template<typename LowerBound>
+    double bisectContact(LowerBound& computeLowerBound, double lower, double upper, double max_speed,
+                         double contact_distance)
+    {
+        while ((upper - lower) * max_speed > contact_distance)
+        {
+            double middle = 0.5 * (lower + upper);
+            if (computeLowerBound(middle) <= contact_distance) { upper = middle; }
+            else { lower = middle; }
+        }
+        return lower;
+    }
+
+    /**
+     * @brief Minimises the separation over [lower, upper] by golden-section search, to within a time whose
+     * separation can differ from the minimum by at most the contact distance. Returns the time of the minimum.
+     */
+    template<typename LowerBound>
+    double minimizeSeparation(LowerBound& computeLowerBound, double lower, double upper, double max_speed,
+                              double contact_distance, double& min_separation)
+    {
+        const double ratio = 0.5 * (std::sqrt(5.0) - 1.0);
+        double left = upper - ratio * (upper - lower);
+        double right = lower + ratio * (upper - lower);
+        double left_separation = computeLowerBound(left);
+        double right_separation = computeLowerBound(right);
+        while ((upper - lower) * max_speed > contact_distance)
+        {
+            if (left_separation <= contact_distance || right_separation <= contact_distance) { break; }
+            if (left_separation < right_separation)
+            {
+                upper = right;
+                right = left;
+                right_separation = left_separation;
+                left = upper - ratio * (upper - lower);
+                left_separation = computeLowerBound(left);
+            }
+            else
+            {
+                lower = left;
+                left = right;
+                left_separation = right_separation;
+                right = lower + ratio * (upper - lower);
+                right_separation = computeLowerBound(right);
+            }
+        }
+
+        min_separation = std::min(left_separation, right_separation);
+        return left_separation < right_separation ? left : right;
+    }
+
+    /**
+     * @brief The gap between two convex sets along a unit direction u, from the first set towards the second:
+     *
+     * gap(u) = u.offset - sqrt(u^T S1 u) - sqrt(u^T S2 u),
+     *
+     * where offset is the second centre minus the first, and S = R D^2 R^T is the support matrix of an
+     * ellipsoid (zero for a point). Every gap is a lower bound on the distance between the sets, and the largest
+     * gap equals the distance when they are disjoint. For a line, u is restricted to be perpendicular to its axis.
+     */
+    struct SeparationProblem
+    {
+        Eigen::Vector3d offset;
+        Eigen::Matrix3d first_support;
+        Eigen::Matrix3d second_support;
+        bool has_axis;
+        Eigen::Vector3d axis;
+    };
+
+    double evaluateSeparation(const SeparationProblem& problem, const Eigen::Vector3d& direction,
+                              Eigen::Vector3d& gradient, Eigen::Matrix3d& hessian)
+    {
+        double separation = direction.dot(problem.offset);
+        gradient = problem.offset;
+        hessian.setZero();
+
+        for (const Eigen::Matrix3d* support : {&problem.first_support, &problem.second_support})
+        {
+            Eigen::Vector3d support_direction = *support * direction;
+            double radius = std::sqrt(std::max(direction.dot(support_direction), 0.0));
+            if (radius == 0.0) { continue; }
+
+            separation -= radius;
+            gradient -= support_direction / radius;
+            hessian -= (*support - support_direction * support_direction.transpose() / (radius * radius)) / radius;
+        }
+
+        return separation;
+    }
+
+    /**
+     * @brief Maximises the gap over unit directions, starting from and updating direction, and returns the gap.
+     *
+     * The gap is concave and positively homogeneous, so while it is positive the Newton iteration on the sphere
+     * has a negative definite Hessian and converges quadratically. Steps are only accepted if they increase the gap.
+     */
+    double maximizeSeparation(const SeparationProblem& problem, Eigen::Vector3d& direction)
+    {
+        const double scale = problem.offset.norm() + std::sqrt(problem.first_support.trace()) +
+                             std::sqrt(problem.second_support.trace());
+        Eigen::Vector3d gradient;
+        Eigen::Matrix3d hessian;
+        double separation = evaluateSeparation(problem, direction, gradient, hessian);
+
+        for (int iteration = 0; iteration < 50; iteration++)
+        {
+            // An orthonormal basis of the directions in which u may move; a line leaves only one
+            Eigen::Matrix<double, 3, 2> basis;
+            if (problem.has_axis)
+            {
+                basis.col(0) = problem.axis.cross(direction).normalized();
+                basis.col(1).setZero();
+            }
+            else
+            {
+                basis.col(0) = direction.unitOrthogonal();
+                basis.col(1) = direction.cross(basis.col(0));
+            }
+
+            Eigen::Vector2d reduced_gradient = basis.transpose() * gradient;
+            if (reduced_gradient.norm() <= 1.0e-12 * scale) { break; }
+
+            Eigen::Matrix2d reduced_hessian = basis.transpose() * hessian * basis;
+            reduced_hessian.diagonal().array() -= direction.dot(gradient);
+            if (problem.has_axis) { reduced_hessian(1, 1) = -1.0; }
+
+            Eigen::Vector2d step;
+            if (reduced_hessian(0, 0) < 0.0 && reduced_hessian.determinant() > 0.0)
+            {
+                step = -reduced_hessian.inverse() * reduced_gradient;
+            }
+            else
+            {
+                step = reduced_gradient / scale;
+            }
+
+            bool improved = false;
+            for (int halving = 0; halving < 30 && !improved; halving++)
+            {
+                Eigen::Vector3d candidate = (direction + basis * step).normalized();
+                Eigen::Vector3d candidate_gradient;
+                Eigen::Matrix3d candidate_hessian;
+                double candidate_separation = evaluateSeparation(problem, candidate, candidate_gradient, candidate_hessian);
+                if (candidate_separation > separation)
+                {
+                    improved = true;
+                    direction = candidate;
+                    gradient = candidate_gradient;
+                    hessian = candidate_hessian;
+                    separation = candidate_separation;
+                }
+                step *= 0.5;
+            }
+            if (!improved) { break; }
+        }
+
+        return separation;
+    }
+
+    /**
+     * @brief Advances time by the separation divided by the largest closing speed, until the separation
+     * falls below the contact distance or the timestep ends.
+     *
+     * Steps shorter than min_advancement are lengthened to it. Such a step is not certified free of contact, so
+     * if it lands in contact the crossing is bisected, and if the separation stops decreasing over it, the
+     * minimum over the last two steps is searched for a contact. This assumes the separation has a single
+     * minimum over any two consecutive steps.
+     */
+    template<typename LowerBound>
+    double advanceConservatively(LowerBound computeLowerBound, double max_speed, double contact_distance)
+    {
+        double separation = computeLowerBound(0.0);
+        if (separation <= contact_distance) { return 0.0; }
+        if (max_speed <= 0.0) { return no_contact; }
+
+        double time = 0.0;
+        double previous_time = 0.0;
+        double previous_separation = separation;
+        while (time < 1.0)
+        {
+            double conservative_step = separation / max_speed;
+            double next_time = std::min(time + std::max(conservative_step, min_advancement), 1.0);
+            double next_separation = computeLowerBound(next_time);
+
+            if (conservative_step < next_time - time)
+            {
+                // The step was lengthened, so contact may have begun and ended within it
+                if (next_separation <= contact_distance)
+                {
+                    return bisectContact(computeLowerBound, time, next_time, max_speed, contact_distance);
+                }
+                // A minimum is bracketed when the separation was decreasing into this step and has now risen
+                if (next_separation >= separation && separation <= previous_separation)
+                {
+                    double min_separation;
+                    double min_time = minimizeSeparation(computeLowerBound, previous_time, next_time, max_speed,
+                                                         contact_distance, min_separation);
+                    if (min_separation <= contact_distance)
+                    {
+                        return bisectContact(computeLowerBound, previous_time, min_time, max_speed, contact_distance);
+                    }
+                }
+            }
+            else if (next_separation <= contact_distance)
+            {
+                return next_time;
+            }
+
+            previous_time = time;
+            previous_separation = separation;
+            time = next_time;
+            separation = next_separation;
+        }
+
+        return no_contact;
+    }
+}
+
+MovingEllipsoid::MovingEllipsoid(const Ellipsoid& start_pose, const Eigen::Vector3d& end_position_vector,
+                                 const Eigen::Matrix3d& end_rotation_matrix)
+    : start_pose(start_pose)
+{
+    start_position = start_pose.getPositionVector();
+    displacement = end_position_vector - start_position;
+    start_rotation = Eigen::Quaterniond(start_pose.getRotationMatrix()).normalized();
+    end_rotation = Eigen::Quaterniond(end_rotation_matrix).normalized();
+    if (start_rotation.dot(end_rotation) < 0.0) { end_rotation.coeffs() *= -1.0; }
+
+    Eigen::Vector3d semi_axes(start_pose.getA(), start_pose.getB(), start_pose.getC());
+    squared_semi_axes = semi_axes.cwiseProduct(semi_axes);
+    bounding_radius = semi_axes.maxCoeff();
+    max_speed = displacement.norm() + start_rotation.angularDistance(end_rotation) * bounding_radius;
+}
+
+Eigen::Vector3d MovingEllipsoid::getPositionVector(double time) const
+{
+    return start_position + time * displacement;
+}
+
+Eigen::Matrix3d MovingEllipsoid::getRotationMatrix(double time) const
+{
+    return start_rotation.slerp(time, end_rotation).toRotationMatrix();
+}
+
+Ellipsoid MovingEllipsoid::getEllipsoid(double time) const
+{
+    return Ellipsoid({start_pose.getA(), start_pose.getB(), start_pose.getC()}, getPositionVector(time),
+                     getRotationMatrix(time), start_pose.getForm());
+}
+
+void MovingEllipsoid::getSweptBoundingSphere(Eigen::Vector3d& centre, double& radius) const
+{
+    centre = start_position + 0.5 * displacement;
+    radius = 0.5 * displacement.norm() + bounding_radius;
+}
+
+Eigen::Matrix3d MovingEllipsoid::computeSupportMatrix(double time) const
+{
+    Eigen::Matrix3d rotation = getRotationMatrix(time);
+    return rotation * squared_semi_axes.asDiagonal() * rotation.transpose();
+}
+
+double MovingEllipsoid::computeTimeOfImpact(const Eigen::Vector3d& point, double tolerance) const
+{
+    auto computeLowerBound = [this, &point](double time)
+    {
+        return getEllipsoid(time).computeSignedDistance(point);
+    };
+
+    return advanceConservatively(computeLowerBound, max_speed, tolerance * bounding_radius);
+}
+
+double MovingEllipsoid::computeRayTimeOfImpact(const Eigen::Vector3d& ray_origin, const Eigen::Vector3d& ray_direction,
+                                               double tolerance) const
+{
+    double direction_norm = ray_direction.norm();
+    if (direction_norm == 0.0) { return computeTimeOfImpact(ray_origin, tolerance); }
+
+    SeparationProblem problem;
+    problem.first_support.setZero();
+    problem.has_axis = true;
+    problem.axis = ray_direction / direction_norm;
+    Eigen::Vector3d direction = Eigen::Vector3d::Zero();
+
+    auto computeLowerBound = [&](double time)
+    {
+        Ellipsoid ellipsoid = getEllipsoid(time);
+        double entry;
+        double exit;
+        if (ellipsoid.computeLineIntersection(ray_origin, problem.axis, entry, exit))
+        {
+            // The line meets the ellipsoid; if only behind the origin, the closest point of the ray is its origin
+            return exit >= 0.0 ? 0.0 : ellipsoid.computeSignedDistance(ray_origin);
+        }
+
+        problem.offset = ellipsoid.getPositionVector() - ray_origin;
+        problem.second_support = computeSupportMatrix(time);
+        if (direction.isZero())
+        {
+            direction = (problem.offset - problem.axis.dot(problem.offset) * problem.axis).normalized();
+        }
+        double separation = maximizeSeparation(problem, direction);
+
+        // The point of the ellipsoid nearest the line is its support point in the direction -u
+        Eigen::Vector3d support_direction = problem.second_support * direction;
+        Eigen::Vector3d nearest_point = ellipsoid.getPositionVector() -
+                                        support_direction / std::sqrt(direction.dot(support_direction));
+        if (problem.axis.dot(nearest_point - ray_origin) < 0.0)
+        {
+            return ellipsoid.computeSignedDistance(ray_origin);
+        }
+
+        return separation;
+    };
+
+    return advanceConservatively(computeLowerBound, max_speed, tolerance * bounding_radius);
+}
+
+double MovingEllipsoid::computeTimeOfImpact(const MovingEllipsoid& other, double tolerance) const
+{
+    // Swept bounding spheres that never meet rule out contact without any advancement
+    Eigen::Vector3d swept_centre;
+    Eigen::Vector3d other_swept_centre;
+    double swept_radius;
+    double other_swept_radius;
+    getSweptBoundingSphere(swept_centre, swept_radius);
+    other.getSweptBoundingSphere(other_swept_centre, other_swept_radius);
+    if ((other_swept_centre - swept_centre).norm() > swept_radius + other_swept_radius) { return no_contact; }
+
+    SeparationProblem problem;
+    problem.has_axis = false;
+    Eigen::Vector3d direction = Eigen::Vector3d::Zero();
+
+    auto computeLowerBound = [&](double time)
+    {
+        problem.offset = other.getPositionVector(time) - getPositionVector(time);
+        problem.first_support = computeSupportMatrix(time);
+        problem.second_support = other.computeSupportMatrix(time);
+        if (direction.isZero())
+        {
+            if (problem.offset.isZero()) { return 0.0; }
+            direction = problem.offset.normalized();
+        }
+        return maximizeSeparation(problem, direction);
+    };
+
+    double contact_distance = tolerance * std::max(bounding_radius, other.bounding_radius);
+    return advanceConservatively(computeLowerBound, max_speed + other.max_speed, contact_distance);
+}
+
+VectorXdMap MovingEllipsoid::computeTimesOfImpact(const std::vector<MovingEllipsoid>& ellipsoids,
+                                                  const Eigen::Ref<const Eigen::Matrix3Xd>& points, Workspace& workspace,
+                                                  double tolerance)
+{
+    if (points.cols() != static_cast<Eigen::Index>(ellipsoids.size()))
+    {
+        throw std::invalid_argument("Time of impact batches need one point per ellipsoid");
+    }
+    Eigen::Index count = static_cast<Eigen::Index>(ellipsoids.size());
+    VectorXdMap contact_times(workspace.allocate<double>(count), count);
+
+    #pragma omp parallel for schedule(dynamic, 16)
+    for (Eigen::Index i = 0; i < count; i++)
+    {
+        contact_times[i] = ellipsoids[i].computeTimeOfImpact(points.col(i), tolerance);
+    }
+
+    return contact_times;
+}
+
+VectorXdMap MovingEllipsoid::computeRayTimesOfImpact(const std::vector<MovingEllipsoid>& ellipsoids,
+                                                     const Eigen::Ref<const Eigen::Matrix3Xd>& ray_origins,
+                                                     const Eigen::Ref<const Eigen::Matrix3Xd>& ray_directions,
+                                                     Workspace& workspace, double tolerance)
+{
+    if (ray_origins.cols() != static_cast<Eigen::Index>(ellipsoids.size()) ||
+        ray_directions.cols() != static_cast<Eigen::Index>(ellipsoids.size()))
+    {
+        throw std::invalid_argument("Ray time of impact batches need one ray origin and direction per ellipsoid");
+    }
+    Eigen::Index count = static_cast<Eigen::Index>(ellipsoids.size());
+    VectorXdMap contact_times(workspace.allocate<double>(count), count);
+
+    #pragma omp parallel for schedule(dynamic, 16)
+    for (Eigen::Index i = 0; i < count; i++)
+    {
+        contact_times[i] = ellipsoids[i].computeRayTimeOfImpact(ray_origins.col(i), ray_directions.col(i), tolerance);
+    }
+
+    return contact_times;
+}
+
+VectorXdMap MovingEllipsoid::computeTimesOfImpact(const std::vector<MovingEllipsoid>& first,
+                                                  const std::vector<MovingEllipsoid>& second, Workspace& workspace,
+                                                  double tolerance)
+{
+    if (first.size() != second.size())
+    {
+        throw std::invalid_argument("Time of impact batches need the same number of first and second ellipsoids");
+    }
+    Eigen::Index count = static_cast<Eigen::Index>(first.size());
+    VectorXdMap contact_times(workspace.allocate<double>(count), count);
+
+    #pragma omp parallel for schedule(dynamic, 16)
+    for (Eigen::Index i = 0; i < count; i++)
+    {
+        contact_times[i] = first[i].computeTimeOfImpact(second[i], tolerance);
+    }
+
+    return contact_times;
+}
@@ -0,0 +1,144 @@
+/**
+ * @file moving_ellipsoid.hpp
+ * @brief Defines the MovingEllipsoid class, an ellipsoid moving between two poses over a timestep.
+ *
+ * Over the timestep, which runs from time 0 to time 1, the position moves linearly and the orientation is
+ * interpolated at a constant angular rate (spherical linear interpolation of quaternions).
+ *
+ * Continuous queries use conservative advancement. The speed of every surface point is bounded by
+ * |displacement| + angle * (largest semi-axis), so a separation d at time t means no contact before
+ * t + d / speed. Separations from points are exact signed distances. Separations from rays and other
+ * ellipsoids are found by maximising the gap between support functions over separating directions. Every
+ * direction tried gives a lower bound on the distance, so the advancement never steps past a contact.
+ *
+ * The continuous queries return the first time in [0, 1] at which the ellipsoid touches the other object, zero
+ * if they already overlap at time 0, and infinity if they do not touch during the timestep. Contact is reported
+ * once the separation falls below tolerance times the largest semi-axis involved.
+ *
+ * Advancement steps shorter than 10^-4 of the timestep, which occur near grazing approaches and shallow contacts,
+ * are lengthened to that size. Over such a step a contact is found by bisection if the step ends in contact, or
+ * by minimising the separation if it stops decreasing. The time returned is then not later than the true time
+ * of contact provided the separation has a single minimum over any two consecutive lengthened steps; a contact
+ * that begins and ends between two local minima inside such a window may be missed.
+ *
+ * Usage:
+ * @code
+ * MovingEllipsoid moving(ellipsoid, end_position, end_rotation);
+ * double contact_time = moving.computeTimeOfImpact(point);
+ * if (contact_time <= 1.0) { Ellipsoid at_contact = moving.getEllipsoid(contact_time); }
+ * @endcode
+ */
+#ifndef MOVING_ELLIPSOID_HPP
+#define MOVING_ELLIPSOID_HPP
+
+#include "ellipsoid.hpp"
+#include <vector>
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+
+/**
+ * @brief An ellipsoid moving linearly, with interpolated rotation, between a start pose and an end pose.
+ */
+class MovingEllipsoid
+{
+public:
+
+    /********** Constructors **********/
+
+    /**
+     * @brief Creates a motion from the pose of start_pose to the given end position and rotation.
+     *
+     * The semi-axes are taken from start_pose. The rotation follows the shorter of the two arcs between the
+     * start and end orientations.
+     */
+    MovingEllipsoid(const Ellipsoid& start_pose, const Eigen::Vector3d& end_position_vector,
+                    const Eigen::Matrix3d& end_rotation_matrix);
+
+    /********** Getters **********/
+
+    Eigen::Vector3d getPositionVector(double time) const;
+    Eigen::Matrix3d getRotationMatrix(double time) const;
+
+    /**
+     * @brief Returns the ellipsoid at the given time in [0, 1].
+     */
+    Ellipsoid getEllipsoid(double time) const;
+
+    /**
+     * @brief Returns an upper bound on the speed of any surface point, in distance per unit time.
+     */
+    double getMaxSpeed() const { return max_speed; }
+
+    /**
+     * @brief Returns a sphere that contains the ellipsoid at every time in [0, 1], for broad-phase culling.
+     */
+    void getSweptBoundingSphere(Eigen::Vector3d& centre, double& radius) const;
+
+    /********** Continuous Queries **********/
+
+    /**
+     * @brief Computes the time of first contact with a fixed point.
+     */
+    double computeTimeOfImpact(const Eigen::Vector3d& point, double tolerance = 1.0e-9) const;
+
+    /**
+     * @brief Computes the time of first contact with a fixed ray.
+     */
+    double computeRayTimeOfImpact(const Eigen::Vector3d& ray_origin, const Eigen::Vector3d& ray_direction,
+                                  double tolerance = 1.0e-9) const;
+
+    /**
+     * @brief Computes the time of first contact with another moving ellipsoid over the same timestep.
+     */
+    double computeTimeOfImpact(const MovingEllipsoid& other, double tolerance = 1.0e-9) const;
+
+    /********** Batch Queries **********/
+
+    /**
+     * @brief Computes the time of first contact of each ellipsoid with the matching column of points, in parallel.
+     *
+     * The results of the batch queries are views into storage allocated from the workspace, valid until the
+     * workspace is reset. The batch queries throw std::invalid_argument if their inputs differ in length.
+     */
+    static VectorXdMap computeTimesOfImpact(const std::vector<MovingEllipsoid>& ellipsoids,
+                                            const Eigen::Ref<const Eigen::Matrix3Xd>& points, Workspace& workspace,
+                                            double tolerance = 1.0e-9);
+
+    /**
+     * @brief Computes the time of first contact of each ellipsoid with the matching ray, in parallel.
+     */
+    static VectorXdMap computeRayTimesOfImpact(const std::vector<MovingEllipsoid>& ellipsoids,
+                                               const Eigen::Ref<const Eigen::Matrix3Xd>& ray_origins,
+                                               const Eigen::Ref<const Eigen::Matrix3Xd>& ray_directions,
+                                               Workspace& workspace, double tolerance = 1.0e-9);
+
+    /**
+     * @brief Computes the time of first contact of each pair first[i], second[i], in parallel.
+     */
+    static VectorXdMap computeTimesOfImpact(const std::vector<MovingEllipsoid>& first,
+                                            const std::vector<MovingEllipsoid>& second, Workspace& workspace,
+                                            double tolerance = 1.0e-9);
+
+private:
+
+    /**
+     * @brief Returns the matrix R D^2 R^T at the given time, whose quadratic form gives the squared support radius.
+     */
+    Eigen::Matrix3d computeSupportMatrix(double time) const;
+
+    Ellipsoid start_pose;
+    Eigen::Vector3d start_position;
+    Eigen::Vector3d displacement;
+    Eigen::Quaterniond start_rotation;
+    Eigen::Quaterniond end_rotation;
+    Eigen::Vector3d squared_semi_axes;
+
+    /**
+     * @brief The largest semi-axis, the radius of the bounding sphere about the centre.
+     */
+    double bounding_radius;
+
+    double max_speed;
+};
+
+#endif // MOVING_ELLIPSOID_HPP
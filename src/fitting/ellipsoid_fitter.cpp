@@ -0,0 +1,290 @@
+#include "ellipsoid_fitter.hpp"
+#include <Eigen/Core>
+#include <Eigen/Eigenvalues>
+#include <Eigen/Geometry>
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace
+{
+    /**
+     * @brief Number of points reduced together; each block is one task for the parallel loops.
+     */
+    constexpr Eigen::Index block_size = 4096;
+
+    using Vector9d = Eigen::Matrix<double, 9, 1>;
+    using Matrix9d = Eigen::Matrix<double, 9, 9>;
+
+    /**
+     * @brief Sets the ellipsoid, sorting the semi-axes into decreasing order and making the rotation proper.
+     */
+    void setFittedEllipsoid(Ellipsoid& ellipsoid, const Eigen::Vector3d& centre, const Eigen::Vector3d& axes,
+                            const Eigen::Matrix3d& rotation)
+    {
+        std::array<int, 3> order = {0, 1, 2};
+        std::sort(order.begin(), order.end(), [&axes](int i, int j) { return axes[i] > axes[j]; });
+
+        Eigen::Matrix3d sorted_rotation;
+        for (int i = 0; i < 3; i++) { sorted_rotation.col(i) = rotation.col(order[i]); }
+        if (sorted_rotation.determinant() < 0.0) { sorted_rotation.col(2) *= -1.0; }
+
+        Eigen::Vector3d position = centre;
+        ellipsoid.setSemiAxes(axes[order[0]], axes[order[1]], axes[order[2]]);
+        ellipsoid.setRotationMatrix(sorted_rotation);
+        ellipsoid.setPositionVector(position);
+    }
+
+    /**
+     * @brief Evaluates the sum of squared signed distances, and the Gauss-Newton normal equations.
+     *
+     * The parameters are ordered as centre (3), semi-axes (3) and a small rotation about the centre (3).
+     */
+    double evaluateGeometricResidual(const Eigen::Ref<const Eigen::Matrix3Xd>& points, const Ellipsoid& ellipsoid,
+                                     Matrix9d& normal_matrix, Vector9d& normal_vector)
+    {
+        const Eigen::Vector3d centre = ellipsoid.getPositionVector();
+        const Eigen::Matrix3d rotation = ellipsoid.getRotationMatrix();
+        const Eigen::Vector3d axes(ellipsoid.getA(), ellipsoid.getB(), ellipsoid.getC());
+        const Eigen::Vector3d inverse_axes_squared = axes.cwiseProduct(axes).cwiseInverse();
+
+        Eigen::Index point_count = points.cols();
+        Eigen::Index block_count = (point_count + block_size - 1) / block_size;
+        double cost = 0.0;
+        normal_matrix.setZero();
+        normal_vector.setZero();
+
+        #pragma omp parallel if(block_count > 1)
+        {
+            Matrix9d local_matrix = Matrix9d::Zero();
+            Vector9d local_vector = Vector9d::Zero();
+            double local_cost = 0.0;
+            Eigen::Index scratch_size = std::min(block_size, point_count);
+            Eigen::Matrix<double, 9, Eigen::Dynamic> jacobian(9, scratch_size);
+            Eigen::Matrix<double, 1, Eigen::Dynamic> residuals(1, scratch_size);
+
+            #pragma omp for schedule(dynamic)
+            for (Eigen::Index block = 0; block < block_count; block++)
+            {
+                Eigen::Index begin = block * block_size;
+                Eigen::Index count = std::min(block_size, point_count - begin);
+                for (Eigen::Index k = 0; k < count; k++)
+                {
+                    Eigen::Vector3d local_query = rotation.transpose() * (points.col(begin + k) - centre);
+                    Eigen::Vector3d local_contact = ellipsoid.computeClosestSurfacePointCanonical(local_query);
+                    Eigen::Vector3d local_normal = local_contact.cwiseProduct(inverse_axes_squared).normalized();
+
+                    // Moving the surface by a displacement u changes the signed distance by -n.u
+                    Eigen::Vector3d normal = rotation * local_normal;
+                    Eigen::Vector3d offset = rotation * local_contact;
+                    residuals(k) = local_normal.dot(local_query - local_contact);
+                    jacobian.col(k).segment<3>(0) = -normal;
+                    jacobian.col(k).segment<3>(3) = -local_normal.cwiseProduct(local_contact).cwiseQuotient(axes);
+                    jacobian.col(k).segment<3>(6) = -offset.cross(normal);
+                }
+
+                auto block_jacobian = jacobian.leftCols(count);
+                auto block_residuals = residuals.leftCols(count);
+                local_matrix.noalias() += block_jacobian * block_jacobian.transpose();
+                local_vector.noalias() += block_jacobian * block_residuals.transpose();
+                local_cost += block_residuals.squaredNorm();
+            }
+
+            #pragma omp critical
+            {
+                normal_matrix += local_matrix;
+                normal_vector += local_vector;
+                cost += local_cost;
+            }
+        }
+
+        return cost;
+    }
+}
+
+EllipsoidFitter::EllipsoidFitter()
+{
+    reset();
+}
+
+void EllipsoidFitter::addPoint(const Eigen::Vector3d& point)
+{
+    if (point_count == 0) { origin = point; }
+    Eigen::Vector3d relative = point - origin;
+
+    Eigen::Matrix<double, 10, 1> monomials;
+    monomials << relative[0] * relative[0], relative[1] * relative[1], relative[2] * relative[2],
+                 2.0 * relative[0] * relative[1], 2.0 * relative[0] * relative[2], 2.0 * relative[1] * relative[2],
+                 2.0 * relative[0], 2.0 * relative[1], 2.0 * relative[2], 1.0;
+    scatter_matrix.noalias() += monomials * monomials.transpose();
+
+    point_count++;
+}
+
+void EllipsoidFitter::addPoints(const Eigen::Ref<const Eigen::Matrix3Xd>& points)
+{
+    Eigen::Index new_point_count = points.cols();
+    if (new_point_count == 0) { return; }
+    if (point_count == 0) { origin = points.col(0); }
+
+    Eigen::Index block_count = (new_point_count + block_size - 1) / block_size;
+    const Eigen::Vector3d fit_origin = origin;
+
+    #pragma omp parallel if(block_count > 1)
+    {
+        Eigen::Matrix<double, 10, 10> local_scatter = Eigen::Matrix<double, 10, 10>::Zero();
+        Eigen::Matrix<double, 10, Eigen::Dynamic> monomials(10, std::min(block_size, new_point_count));
+
+        #pragma omp for schedule(static)
+        for (Eigen::Index block = 0; block < block_count; block++)
+        {
+            Eigen::Index begin = block * block_size;
+            Eigen::Index count = std::min(block_size, new_point_count - begin);
+            auto relative = (points.middleCols(begin, count).colwise() - fit_origin).array();
+
+            auto block_monomials = monomials.leftCols(count);
+            block_monomials.row(0) = relative.row(0).square().matrix();
+            block_monomials.row(1) = relative.row(1).square().matrix();
+            block_monomials.row(2) = relative.row(2).square().matrix();
+            block_monomials.row(3) = (2.0 * relative.row(0) * relative.row(1)).matrix();
+            block_monomials.row(4) = (2.0 * relative.row(0) * relative.row(2)).matrix();
+            block_monomials.row(5) = (2.0 * relative.row(1) * relative.row(2)).matrix();
+            block_monomials.middleRows(6, 3) = 2.0 * relative.matrix();
+            block_monomials.row(9).setOnes();
+
+            local_scatter.noalias() += block_monomials * block_monomials.transpose();
+        }
+
+        #pragma omp critical
+        scatter_matrix += local_scatter;
+    }
+
+    point_count += static_cast<std::size_t>(new_point_count);
+}
+
+void EllipsoidFitter::reset()
+{
+    scatter_matrix.setZero();
+    origin.setZero();
+    point_count = 0;
+}
+
+bool EllipsoidFitter::fitAlgebraic(Ellipsoid& ellipsoid) const
+{
+    if (point_count < 9) { return false; }
+
+    // Minimise v^T S v subject to |D^-1 v| = 1, with D chosen to equilibrate the scatter matrix
+    Eigen::Matrix<double, 10, 1> scaling;
+    for (int i = 0; i < 10; i++)
+    {
+        scaling[i] = scatter_matrix(i, i) > 0.0 ? 1.0 / std::sqrt(scatter_matrix(i, i)) : 1.0;
+    }
+    Eigen::Matrix<double, 10, 10> scaled_scatter = scaling.asDiagonal() * scatter_matrix * scaling.asDiagonal();
+    Eigen::SelfAdjointEigenSolver<Eigen::Matrix<double, 10, 10>> scatter_solver(scaled_scatter);
+    Eigen::Matrix<double, 10, 1> coefficients = scaling.cwiseProduct(scatter_solver.eigenvectors().col(0));
+
+    Eigen::Matrix3d quadric;
+    quadric << coefficients[0], coefficients[3], coefficients[4],
+               coefficients[3], coefficients[1], coefficients[5],
+               coefficients[4], coefficients[5], coefficients[2];
+    Eigen::Vector3d linear = coefficients.segment<3>(6);
+    double constant = coefficients[9];
+
+    // The coefficients are only defined up to sign; an ellipsoid needs a definite quadric
+    if (quadric.trace() < 0.0)
+    {
+        quadric = -quadric;
+        linear = -linear;
+        constant = -constant;
+    }
+
+    Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> quadric_solver(quadric);
+    Eigen::Vector3d eigenvalues = quadric_solver.eigenvalues();
+    if (eigenvalues.minCoeff() <= 0.0) { return false; }
+
+    // (x - c)^T Q (x - c) = c^T Q c - J, with c = -Q^-1 g
+    Eigen::Vector3d centre = -quadric_solver.eigenvectors() *
+        (quadric_solver.eigenvectors().transpose() * linear).cwiseQuotient(eigenvalues);
+    double level = centre.dot(quadric * centre) - constant;
+    if (level <= 0.0) { return false; }
+
+    Eigen::Vector3d axes = (level * eigenvalues.cwiseInverse()).cwiseSqrt();
+    setFittedEllipsoid(ellipsoid, centre + origin, axes, quadric_solver.eigenvectors());
+
+    return true;
+}
+
+bool EllipsoidFitter::refineGeometric(const Eigen::Ref<const Eigen::Matrix3Xd>& points, Ellipsoid& ellipsoid,
+                                      int max_iterations)
+{
+    if (points.cols() < 9) { return false; }
+
+    Matrix9d normal_matrix;
+    Vector9d normal_vector;
+    double cost = evaluateGeometricResidual(points, ellipsoid, normal_matrix, normal_vector);
+    double initial_cost = cost;
+    double damping = 1.0e-3 * normal_matrix.diagonal().mean();
+
+    for (int iteration = 0; iteration < max_iterations; iteration++)
+    {
+        Matrix9d damped_matrix = normal_matrix;
+        damped_matrix.diagonal() += damping * (normal_matrix.diagonal().array() + 1.0e-12).matrix();
+        Vector9d step = damped_matrix.ldlt().solve(-normal_vector);
+
+        Eigen::Vector3d centre = ellipsoid.getPositionVector() + step.segment<3>(0);
+        Eigen::Vector3d axes = Eigen::Vector3d(ellipsoid.getA(), ellipsoid.getB(), ellipsoid.getC()) + step.segment<3>(3);
+        Eigen::Vector3d rotation_vector = step.segment<3>(6);
+        Eigen::Matrix3d rotation = ellipsoid.getRotationMatrix();
+        if (rotation_vector.norm() > 0.0)
+        {
+            rotation = Eigen::AngleAxisd(rotation_vector.norm(), rotation_vector.normalized()) * rotation;
+        }
+
+        bool accepted = false;
+        if (axes.minCoeff() > 0.0)
+        {
+            Ellipsoid candidate = ellipsoid;
+            setFittedEllipsoid(candidate, centre, axes, rotation);
+
+            Matrix9d candidate_matrix;
+            Vector9d candidate_vector;
+            double candidate_cost = evaluateGeometricResidual(points, candidate, candidate_matrix, candidate_vector);
+            if (candidate_cost < cost)
+            {
+                accepted = true;
+                double relative_decrease = (cost - candidate_cost) / cost;
+                ellipsoid = candidate;
+                normal_matrix = candidate_matrix;
+                normal_vector = candidate_vector;
+                cost = candidate_cost;
+                damping *= 0.1;
+                if (relative_decrease < 1.0e-12) { break; }
+            }
+        }
+
+        if (!accepted)
+        {
+            damping *= 10.0;
+            if (step.norm() < 1.0e-14 * (1.0 + ellipsoid.getA())) { break; }
+        }
+    }
+
+    return cost < initial_cost || cost == 0.0;
+}
+
+double EllipsoidFitter::computeRmsDistance(const Eigen::Ref<const Eigen::Matrix3Xd>& points, const Ellipsoid& ellipsoid)
+{
+    Eigen::Index point_count = points.cols();
+    if (point_count == 0) { return 0.0; }
+
+    double sum_squared_distance = 0.0;
+
+    #pragma omp parallel for reduction(+ : sum_squared_distance) schedule(static)
+    for (Eigen::Index i = 0; i < point_count; i++)
+    {
+        Eigen::Vector3d query_point = points.col(i);
+        sum_squared_distance += (ellipsoid.computeClosestSurfacePoint(query_point) - query_point).squaredNorm();
+    }
+
+    return std::sqrt(sum_squared_distance / static_cast<double>(point_count));
+}
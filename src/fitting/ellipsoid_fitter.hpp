@@ -0,0 +1,109 @@
+/**
+ * @file ellipsoid_fitter.hpp
+ * @brief Defines the EllipsoidFitter class, which fits ellipsoids to point clouds.
+ *
+ * Fitting is done in two stages. An algebraic fit finds the quadric
+ * Ax^2 + By^2 + Cz^2 + 2Dxy + 2Exz + 2Fyz + 2Gx + 2Hy + 2Iz + J = 0
+ * minimising the algebraic residual over the accumulated points. Because the normal equations only depend on
+ * the accumulated scatter matrix, points can be streamed in with addPoints() and the fit updated at any time.
+ * A geometric refinement then minimises the sum of squared orthogonal distances, using the closest surface
+ * point of the ellipsoid as the residual kernel.
+ *
+ * Accumulation and refinement are split into blocks of points that are processed in parallel when OpenMP is
+ * available, with each block reduced by Eigen's vectorised matrix products.
+ *
+ * Usage:
+ * @code
+ * EllipsoidFitter fitter;
+ * fitter.addPoints(points);
+ * Ellipsoid ellipsoid;
+ * if (fitter.fitAlgebraic(ellipsoid))
+ * {
+ *     fitter.refineGeometric(points, ellipsoid);
+ * }
+ * @endcode
+ */
+#ifndef ELLIPSOID_FITTER_HPP
+#define ELLIPSOID_FITTER_HPP
+
+#include "ellipsoid.hpp"
+#include <cstddef>
+#include <Eigen/Core>
+
+/**
+ * @brief Fits an Ellipsoid to a point cloud, supporting incremental updates as points are streamed in.
+ */
+class EllipsoidFitter
+{
+public:
+
+    /********** Constructors **********/
+
+    /**
+     * @brief Default constructor.
+     * Creates a fitter with no accumulated points.
+     */
+    EllipsoidFitter();
+
+    /********** Accumulation **********/
+
+    /**
+     * @brief Adds a single point to the algebraic fit.
+     */
+    void addPoint(const Eigen::Vector3d& point);
+
+    /**
+     * @brief Adds each column of points to the algebraic fit.
+     */
+    void addPoints(const Eigen::Ref<const Eigen::Matrix3Xd>& points);
+
+    /**
+     * @brief Discards all accumulated points.
+     */
+    void reset();
+
+    std::size_t getPointCount() const { return point_count; }
+
+    /********** Fitting **********/
+
+    /**
+     * @brief Fits an ellipsoid to all points added so far, by algebraic least squares.
+     *
+     * The semi-axes are sorted so that a >= b >= c, and the rotation matrix is proper.
+     * Returns false, leaving the ellipsoid unchanged, if fewer than nine points have been added or the best-fit
+     * quadric is not an ellipsoid.
+     */
+    bool fitAlgebraic(Ellipsoid& ellipsoid) const;
+
+    /**
+     * @brief Refines an ellipsoid by minimising the sum of squared distances from points to its surface.
+     *
+     * Uses Levenberg-Marquardt iterations over the centre, semi-axes and orientation, starting from the given
+     * ellipsoid. Returns false if the refinement could not reduce the residual from its starting value.
+     */
+    static bool refineGeometric(const Eigen::Ref<const Eigen::Matrix3Xd>& points, Ellipsoid& ellipsoid,
+                                int max_iterations = 20);
+
+    /**
+     * @brief Computes the root-mean-square distance from points to the surface of the ellipsoid.
+     */
+    static double computeRmsDistance(const Eigen::Ref<const Eigen::Matrix3Xd>& points, const Ellipsoid& ellipsoid);
+
+private:
+
+    /**
+     * @brief The sum of d * d^T over all points, where d holds the quadric monomials of a point.
+     *
+     * Points are taken relative to origin, which keeps the higher-order moments well conditioned.
+     */
+    Eigen::Matrix<double, 10, 10> scatter_matrix;
+
+    /**
+     * @brief The first point added, used as the origin for all accumulated monomials.
+     */
+    Eigen::Vector3d origin;
+
+    std::size_t point_count;
+};
+
+#endif // ELLIPSOID_FITTER_HPP
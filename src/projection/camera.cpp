@@ -0,0 +1,109 @@
+#include "camera.hpp"
+#include "workspace.hpp"
+#include <Eigen/Core>
+#include <Eigen/Eigenvalues>
+#include <cmath>
+
+Camera::Camera(CameraModel model, double focal_length_x, double focal_length_y, const Eigen::Vector2d& principal_point)
+    : model(model)
+{
+    intrinsic_matrix.setZero();
+    intrinsic_matrix(0, 0) = focal_length_x;
+    intrinsic_matrix(1, 1) = focal_length_y;
+    if (model == CameraModel::Perspective)
+    {
+        intrinsic_matrix.block<2, 1>(0, 2) = principal_point;
+        intrinsic_matrix(2, 2) = 1.0;
+    }
+    else
+    {
+        intrinsic_matrix.block<2, 1>(0, 3) = principal_point;
+        intrinsic_matrix(2, 3) = 1.0;
+    }
+
+    position = Eigen::Vector3d(0.0, 0.0, 0.0);
+    orientation = Eigen::Matrix3d::Identity();
+    updateProjectionMatrix();
+}
+
+void Camera::setPositionVector(const Eigen::Vector3d& input_position)
+{
+    position = input_position;
+    updateProjectionMatrix();
+}
+
+void Camera::setRotationMatrix(const Eigen::Matrix3d& input_rotation)
+{
+    orientation = input_rotation;
+    updateProjectionMatrix();
+}
+
+void Camera::updateProjectionMatrix()
+{
+    Eigen::Matrix4d world_to_camera = Eigen::Matrix4d::Identity();
+    world_to_camera.topLeftCorner<3, 3>() = orientation.transpose();
+    world_to_camera.topRightCorner<3, 1>() = -orientation.transpose() * position;
+    projection_matrix = intrinsic_matrix * world_to_camera;
+}
+
+Eigen::Vector2d Camera::projectPoint(const Eigen::Vector3d& point) const
+{
+    Eigen::Vector3d image_point = projection_matrix * point.homogeneous();
+    return image_point.hnormalized();
+}
+
+bool Camera::projectEllipsoid(const Ellipsoid& ellipsoid, Ellipse& outline) const
+{
+    // With H the ellipsoid transform, Q* = H diag(a^2, b^2, c^2, -1) H^T, so P Q* P^T = G D G^T with G = P H
+    const Eigen::Matrix3d rotation = ellipsoid.getRotationMatrix();
+    const Eigen::Vector3d centre = ellipsoid.getPositionVector();
+    const Eigen::Vector3d squared_axes(ellipsoid.getA() * ellipsoid.getA(), ellipsoid.getB() * ellipsoid.getB(),
+                                       ellipsoid.getC() * ellipsoid.getC());
+
+    Eigen::Matrix3d axis_images = projection_matrix.leftCols<3>() * rotation;
+    Eigen::Vector3d centre_image = projection_matrix.leftCols<3>() * centre + projection_matrix.col(3);
+    Eigen::Matrix3d dual_conic = axis_images * squared_axes.asDiagonal() * axis_images.transpose() -
+                                 centre_image * centre_image.transpose();
+
+    // C*(2, 2) is the dual quadric evaluated on the plane through the camera centre parallel to the image. It
+    // is negative when that plane misses the ellipsoid, and the centre image depth is positive when in front.
+    if (!(dual_conic(2, 2) < 0.0) || !(centre_image[2] > 0.0)) { return false; }
+    dual_conic /= -dual_conic(2, 2);
+
+    Eigen::Vector2d outline_centre = -dual_conic.block<2, 1>(0, 2);
+    Eigen::Matrix2d shape = dual_conic.topLeftCorner<2, 2>() + outline_centre * outline_centre.transpose();
+
+    Eigen::SelfAdjointEigenSolver<Eigen::Matrix2d> shape_solver;
+    shape_solver.computeDirect(shape);
+    Eigen::Vector2d eigenvalues = shape_solver.eigenvalues();
+    if (!(eigenvalues[0] > 0.0)) { return false; }
+
+    // Eigenvalues are in increasing order, and the a axis is the larger
+    Eigen::Matrix2d outline_rotation;
+    outline_rotation.col(0) = shape_solver.eigenvectors().col(1);
+    outline_rotation.col(1) = shape_solver.eigenvectors().col(0);
+    if (outline_rotation.determinant() < 0.0) { outline_rotation.col(1) *= -1.0; }
+
+    outline.setA(std::sqrt(eigenvalues[1]));
+    outline.setB(std::sqrt(eigenvalues[0]));
+    outline.setPositionVector(outline_centre);
+    outline.setRotationMatrix(outline_rotation);
+
+    return true;
+}
+
+ArrayXbMap Camera::projectEllipsoids(const std::vector<Ellipsoid>& ellipsoids, std::vector<Ellipse>& outlines,
+                                     Workspace& workspace) const
+{
+    Eigen::Index count = static_cast<Eigen::Index>(ellipsoids.size());
+    outlines.resize(ellipsoids.size());
+    ArrayXbMap projected(workspace.allocate<bool>(ellipsoids.size()), count);
+
+    #pragma omp parallel for schedule(static)
+    for (Eigen::Index i = 0; i < count; i++)
+    {
+        projected[i] = projectEllipsoid(ellipsoids[i], outlines[i]);
+    }
+
+    return projected;
+}
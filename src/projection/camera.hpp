@@ -0,0 +1,122 @@
+/**
+ * @file camera.hpp
+ * @brief Defines the Camera class, which projects ellipsoids to their outlines in the image plane.
+ *
+ * The outline of an ellipsoid in an image is the conic dual to the projection of its dual quadric,
+ * C* = P Q* P^T, where P is the 3x4 camera matrix and Q* the 4x4 dual quadric of the ellipsoid. When
+ * C* is scaled so that C*(2, 2) = -1, the centre of the outline ellipse is -C*(0:1, 2) and its shape matrix is
+ * C*(0:1, 0:1) + centre * centre^T, whose eigen-decomposition gives the semi-axes and orientation. No meshes
+ * or iterations are involved.
+ *
+ * The camera frame has x to the right and y down the image, and z along the viewing direction. As for
+ * Ellipsoid, the columns of the rotation matrix are the camera axes in world coordinates.
+ *
+ * Usage:
+ * @code
+ * Camera camera(CameraModel::Perspective, 800.0, 800.0, Eigen::Vector2d(640.0, 360.0));
+ * camera.setPositionVector(camera_position);
+ * camera.setRotationMatrix(camera_rotation);
+ * Ellipse outline;
+ * if (camera.projectEllipsoid(ellipsoid, outline)) { ... }
+ * @endcode
+ */
+#ifndef CAMERA_HPP
+#define CAMERA_HPP
+
+#include "ellipse.hpp"
+#include "ellipsoid.hpp"
+#include <vector>
+#include <Eigen/Core>
+
+enum class CameraModel
+{
+    Perspective,
+    Orthographic
+};
+
+/**
+ * @brief A pinhole or orthographic camera with a pose and intrinsic parameters, in pixels.
+ */
+class Camera
+{
+public:
+
+    /********** Constructors **********/
+
+    /**
+     * @brief Creates a camera at the origin looking along +z.
+     *
+     * For a perspective camera the focal lengths are in pixels, so that a point (x, y, z) in the camera frame
+     * projects to (fx x / z + cx, fy y / z + cy). For an orthographic camera they are pixels per unit length,
+     * and the point projects to (fx x + cx, fy y + cy).
+     */
+    Camera(CameraModel model, double focal_length_x, double focal_length_y, const Eigen::Vector2d& principal_point);
+
+    /********** Getters **********/
+
+    CameraModel getModel() const { return model; }
+    Eigen::Vector3d getPositionVector() const { return position; }
+    Eigen::Matrix3d getRotationMatrix() const { return orientation; }
+
+    /**
+     * @brief Returns the 3x4 matrix that maps homogeneous world points to homogeneous image points.
+     */
+    const Eigen::Matrix<double, 3, 4>& getProjectionMatrix() const { return projection_matrix; }
+
+    /********** Setters **********/
+
+    void setPositionVector(const Eigen::Vector3d& input_position);
+    void setRotationMatrix(const Eigen::Matrix3d& input_rotation);
+
+    /********** Projection **********/
+
+    /**
+     * @brief Projects a world point to image coordinates.
+     */
+    Eigen::Vector2d projectPoint(const Eigen::Vector3d& point) const;
+
+    /**
+     * @brief Computes the outline of the ellipsoid in the image.
+     *
+     * Returns false, leaving outline unchanged, if the outline is not an ellipse. For a perspective camera this
+     * is the case unless the ellipsoid lies entirely in front of the plane through the camera centre parallel
+     * to the image. An orthographic camera projects every ellipsoid, regardless of depth.
+     */
+    bool projectEllipsoid(const Ellipsoid& ellipsoid, Ellipse& outline) const;
+
+    /**
+     * @brief Computes the outline of every ellipsoid, in parallel.
+     *
+     * outlines is resized to match ellipsoids, reusing its capacity. The returned flags, a view into storage
+     * allocated from the workspace, record which outlines were projected.
+     */
+    ArrayXbMap projectEllipsoids(const std::vector<Ellipsoid>& ellipsoids, std::vector<Ellipse>& outlines,
+                                 Workspace& workspace) const;
+
+private:
+
+    void updateProjectionMatrix();
+
+    CameraModel model;
+
+    /**
+     * @brief The intrinsic matrix, mapping camera coordinates to homogeneous image coordinates.
+     *
+     * For an orthographic camera the last row is (0, 0, 0, 1), so depth is discarded.
+     */
+    Eigen::Matrix<double, 3, 4> intrinsic_matrix;
+
+    /**
+     * @brief The location of the camera centre in world coordinates.
+     */
+    Eigen::Vector3d position;
+
+    /**
+     * @brief The orientation of the camera, with the camera x, y and z axes as columns.
+     */
+    Eigen::Matrix3d orientation;
+
+    Eigen::Matrix<double, 3, 4> projection_matrix;
+};
+
+#endif // CAMERA_HPP
@@ -0,0 +1,313 @@
+#include "tessellator.hpp"
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace
+{
+    constexpr double pi = 3.14159265358979323846;
+
+    /**
+     * @brief Throws if the vertices of a batch cannot all be addressed by 32-bit indices.
+     */
+    void checkVertexCount(std::size_t vertex_count)
+    {
+        if (vertex_count > std::numeric_limits<std::uint32_t>::max())
+        {
+            throw std::length_error("Ellipsoid mesh batch has more vertices than 32-bit indices can address");
+        }
+    }
+
+    /**
+     * @brief Builds a unit-sphere mesh from double-precision vertices, recording its largest edge angle.
+     */
+    UnitSphereMesh buildMesh(const std::vector<Eigen::Vector3d>& vertices, const std::vector<std::uint32_t>& indices)
+    {
+        UnitSphereMesh mesh;
+        mesh.vertices.reserve(3 * vertices.size());
+        for (const Eigen::Vector3d& vertex : vertices)
+        {
+            mesh.vertices.push_back(static_cast<float>(vertex[0]));
+            mesh.vertices.push_back(static_cast<float>(vertex[1]));
+            mesh.vertices.push_back(static_cast<float>(vertex[2]));
+        }
+        mesh.indices = indices;
+
+        mesh.max_edge_angle = 0.0;
+        for (std::size_t i = 0; i < indices.size(); i += 3)
+        {
+            for (int edge = 0; edge < 3; edge++)
+            {
+                const Eigen::Vector3d& start = vertices[indices[i + edge]];
+                const Eigen::Vector3d& end = vertices[indices[i + (edge + 1) % 3]];
+                double angle = std::atan2(start.cross(end).norm(), start.dot(end));
+                mesh.max_edge_angle = std::max(mesh.max_edge_angle, angle);
+            }
+        }
+
+        return mesh;
+    }
+
+    std::vector<UnitSphereMesh> buildIcospheres(int max_level)
+    {
+        const double t = 0.5 * (1.0 + std::sqrt(5.0));
+        std::vector<Eigen::Vector3d> vertices = {
+            {-1.0, t, 0.0}, {1.0, t, 0.0}, {-1.0, -t, 0.0}, {1.0, -t, 0.0},
+            {0.0, -1.0, t}, {0.0, 1.0, t}, {0.0, -1.0, -t}, {0.0, 1.0, -t},
+            {t, 0.0, -1.0}, {t, 0.0, 1.0}, {-t, 0.0, -1.0}, {-t, 0.0, 1.0}};
+        for (Eigen::Vector3d& vertex : vertices) { vertex.normalize(); }
+
+        std::vector<std::uint32_t> indices = {
+            0, 11, 5,   0, 5, 1,    0, 1, 7,    0, 7, 10,   0, 10, 11,
+            1, 5, 9,    5, 11, 4,   11, 10, 2,  10, 7, 6,   7, 1, 8,
+            3, 9, 4,    3, 4, 2,    3, 2, 6,    3, 6, 8,    3, 8, 9,
+            4, 9, 5,    2, 4, 11,   6, 2, 10,   8, 6, 7,    9, 8, 1};
+
+        std::vector<UnitSphereMesh> meshes;
+        meshes.push_back(buildMesh(vertices, indices));
+
+        for (int level = 1; level <= max_level; level++)
+        {
+            // Split each triangle into four, sharing the midpoint of each edge between its two triangles
+            std::unordered_map<std::uint64_t, std::uint32_t> midpoints;
+            auto getMidpoint = [&vertices, &midpoints](std::uint32_t first, std::uint32_t second)
+            {
+                std::uint64_t key = (static_cast<std::uint64_t>(std::min(first, second)) << 32) | std::max(first, second);
+                auto found = midpoints.find(key);
+                if (found != midpoints.end()) { return found->second; }
+
+                std::uint32_t index = static_cast<std::uint32_t>(vertices.size());
+                vertices.push_back((vertices[first] + vertices[second]).normalized());
+                midpoints.emplace(key, index);
+                return index;
+            };
+
+            std::vector<std::uint32_t> refined_indices;
+            refined_indices.reserve(4 * indices.size());
+            for (std::size_t i = 0; i < indices.size(); i += 3)
+            {
+                std::uint32_t a = indices[i];
+                std::uint32_t b = indices[i + 1];
+                std::uint32_t c = indices[i + 2];
+                std::uint32_t ab = getMidpoint(a, b);
+                std::uint32_t bc = getMidpoint(b, c);
+                std::uint32_t ca = getMidpoint(c, a);
+                refined_indices.insert(refined_indices.end(), {a, ab, ca, b, bc, ab, c, ca, bc, ab, bc, ca});
+            }
+            indices = std::move(refined_indices);
+
+            meshes.push_back(buildMesh(vertices, indices));
+        }
+
+        return meshes;
+    }
+
+    UnitSphereMesh buildUVSphere(int stacks, int slices)
+    {
+        std::vector<Eigen::Vector3d> vertices;
+        vertices.reserve(2 + (stacks - 1) * slices);
+        vertices.emplace_back(0.0, 0.0, 1.0);
+        for (int i = 1; i < stacks; i++)
+        {
+            double polar_angle = pi * i / stacks;
+            for (int j = 0; j < slices; j++)
+            {
+                double azimuth = 2.0 * pi * j / slices;
+                vertices.emplace_back(std::sin(polar_angle) * std::cos(azimuth),
+                                      std::sin(polar_angle) * std::sin(azimuth),
+                                      std::cos(polar_angle));
+            }
+        }
+        vertices.emplace_back(0.0, 0.0, -1.0);
+
+        auto ringVertex = [slices](int ring, int slice)
+        {
+            return static_cast<std::uint32_t>(1 + (ring - 1) * slices + slice % slices);
+        };
+        std::uint32_t south_pole = static_cast<std::uint32_t>(vertices.size() - 1);
+
+        std::vector<std::uint32_t> indices;
+        indices.reserve(6 * (stacks - 1) * slices);
+        for (int j = 0; j < slices; j++)
+        {
+            indices.insert(indices.end(), {0, ringVertex(1, j), ringVertex(1, j + 1)});
+        }
+        for (int i = 1; i < stacks - 1; i++)
+        {
+            for (int j = 0; j < slices; j++)
+            {
+                std::uint32_t upper = ringVertex(i, j);
+                std::uint32_t upper_next = ringVertex(i, j + 1);
+                std::uint32_t lower = ringVertex(i + 1, j);
+                std::uint32_t lower_next = ringVertex(i + 1, j + 1);
+                indices.insert(indices.end(), {upper, lower, lower_next, upper, lower_next, upper_next});
+            }
+        }
+        for (int j = 0; j < slices; j++)
+        {
+            indices.insert(indices.end(), {ringVertex(stacks - 1, j), south_pole, ringVertex(stacks - 1, j + 1)});
+        }
+
+        return buildMesh(vertices, indices);
+    }
+}
+
+Tessellator::Tessellator(SphereTemplate template_type, int max_level) : template_type(template_type)
+{
+    max_level = std::max(max_level, 0);
+    if (template_type == SphereTemplate::Icosphere)
+    {
+        templates = buildIcospheres(max_level);
+    }
+    else
+    {
+        for (int level = 0; level <= max_level; level++)
+        {
+            templates.push_back(buildUVSphere(4 << level, 8 << level));
+        }
+    }
+}
+
+int Tessellator::selectRefinementLevel(const Ellipsoid& ellipsoid, double tolerance) const
+{
+    double max_axis = std::max({ellipsoid.getA(), ellipsoid.getB(), ellipsoid.getC()});
+    double min_axis = std::min({ellipsoid.getA(), ellipsoid.getB(), ellipsoid.getC()});
+    double max_curvature = max_axis / (min_axis * min_axis);
+
+    for (int level = 0; level < getMaxLevel(); level++)
+    {
+        double edge_length = max_axis * templates[level].max_edge_angle;
+        if (max_curvature * edge_length * edge_length / 8.0 <= tolerance) { return level; }
+    }
+
+    return getMaxLevel();
+}
+
+EllipsoidMeshLayout Tessellator::planEllipsoids(const std::vector<Ellipsoid>& ellipsoids, double tolerance) const
+{
+    EllipsoidMeshLayout layout;
+    layout.levels.resize(ellipsoids.size());
+    layout.vertex_offsets.resize(ellipsoids.size());
+    layout.index_offsets.resize(ellipsoids.size());
+    layout.vertex_count = 0;
+    layout.index_count = 0;
+
+    for (std::size_t i = 0; i < ellipsoids.size(); i++)
+    {
+        int level = selectRefinementLevel(ellipsoids[i], tolerance);
+        layout.levels[i] = level;
+        layout.vertex_offsets[i] = layout.vertex_count;
+        layout.index_offsets[i] = layout.index_count;
+        layout.vertex_count += templates[level].getVertexCount();
+        layout.index_count += templates[level].getIndexCount();
+    }
+    checkVertexCount(layout.vertex_count);
+
+    return layout;
+}
+
+EllipsoidMeshLayout Tessellator::planEllipsoids(const std::vector<Ellipsoid>& ellipsoids, int level) const
+{
+    level = std::clamp(level, 0, getMaxLevel());
+    std::size_t vertex_count = templates[level].getVertexCount();
+    std::size_t index_count = templates[level].getIndexCount();
+
+    EllipsoidMeshLayout layout;
+    layout.levels.assign(ellipsoids.size(), level);
+    layout.vertex_offsets.resize(ellipsoids.size());
+    layout.index_offsets.resize(ellipsoids.size());
+    for (std::size_t i = 0; i < ellipsoids.size(); i++)
+    {
+        layout.vertex_offsets[i] = i * vertex_count;
+        layout.index_offsets[i] = i * index_count;
+    }
+    layout.vertex_count = ellipsoids.size() * vertex_count;
+    layout.index_count = ellipsoids.size() * index_count;
+    checkVertexCount(layout.vertex_count);
+
+    return layout;
+}
+
+void Tessellator::tessellateEllipsoid(const Ellipsoid& ellipsoid, int level, float* vertices, float* normals,
+                                      std::uint32_t* indices, std::uint32_t base_vertex) const
+{
+    if (level < 0 || level > getMaxLevel()) { throw std::out_of_range("Refinement level has no sphere template"); }
+    const UnitSphereMesh& mesh = templates[level];
+    Eigen::Index vertex_count = static_cast<Eigen::Index>(mesh.getVertexCount());
+    Eigen::Index index_count = static_cast<Eigen::Index>(mesh.getIndexCount());
+    Eigen::Map<const Eigen::Matrix3Xf> unit_vertices(mesh.vertices.data(), 3, vertex_count);
+
+    // Vertices map as R * diag(a, b, c) * u + p, and normals as R * diag(1/a, 1/b, 1/c) * u
+    Eigen::Matrix3d rotation = ellipsoid.getRotationMatrix();
+    Eigen::Vector3d axes(ellipsoid.getA(), ellipsoid.getB(), ellipsoid.getC());
+
+    Eigen::Map<Eigen::Matrix3Xf> output_vertices(vertices, 3, vertex_count);
+    output_vertices.noalias() = (rotation * axes.asDiagonal()).cast<float>() * unit_vertices;
+    output_vertices.colwise() += ellipsoid.getPositionVector().cast<float>();
+
+    if (normals != nullptr)
+    {
+        Eigen::Map<Eigen::Matrix3Xf> output_normals(normals, 3, vertex_count);
+        output_normals.noalias() = (rotation * axes.cwiseInverse().asDiagonal()).cast<float>() * unit_vertices;
+        output_normals.colwise().normalize();
+    }
+
+    Eigen::Map<const Eigen::Array<std::uint32_t, Eigen::Dynamic, 1>> unit_indices(mesh.indices.data(), index_count);
+    Eigen::Map<Eigen::Array<std::uint32_t, Eigen::Dynamic, 1>> output_indices(indices, index_count);
+    output_indices = unit_indices + base_vertex;
+}
+
+void Tessellator::tessellateEllipsoids(const std::vector<Ellipsoid>& ellipsoids, const EllipsoidMeshLayout& layout,
+                                       float* vertices, float* normals, std::uint32_t* indices) const
+{
+    checkVertexCount(layout.vertex_count);
+    if (layout.levels.size() != ellipsoids.size())
+    {
+        throw std::invalid_argument("Ellipsoid mesh layout was planned for a different batch");
+    }
+    for (int level : layout.levels)
+    {
+        if (level < 0 || level > getMaxLevel()) { throw std::out_of_range("Refinement level has no sphere template"); }
+    }
+    std::int64_t ellipsoid_count = static_cast<std::int64_t>(ellipsoids.size());
+
+    #pragma omp parallel for schedule(dynamic, 256)
+    for (std::int64_t i = 0; i < ellipsoid_count; i++)
+    {
+        std::size_t vertex_offset = layout.vertex_offsets[i];
+        tessellateEllipsoid(ellipsoids[i], layout.levels[i], vertices + 3 * vertex_offset,
+                            normals != nullptr ? normals + 3 * vertex_offset : nullptr,
+                            indices + layout.index_offsets[i], static_cast<std::uint32_t>(vertex_offset));
+    }
+}
+
+void Tessellator::tessellateEllipses(const std::vector<Ellipse>& ellipses, int point_count, float* vertices)
+{
+    if (point_count < 2) { throw std::invalid_argument("An ellipse polyline needs at least two points"); }
+
+    // The unit circle is shared by every ellipse
+    Eigen::Matrix2Xd unit_circle(2, point_count);
+    for (int k = 0; k < point_count; k++)
+    {
+        double angle = 2.0 * pi * k / point_count;
+        unit_circle(0, k) = std::cos(angle);
+        unit_circle(1, k) = std::sin(angle);
+    }
+    Eigen::Matrix2Xf unit_points = unit_circle.cast<float>();
+
+    std::int64_t ellipse_count = static_cast<std::int64_t>(ellipses.size());
+
+    #pragma omp parallel for schedule(static)
+    for (std::int64_t i = 0; i < ellipse_count; i++)
+    {
+        const Ellipse& ellipse = ellipses[i];
+        Eigen::Vector2d axes(ellipse.getA(), ellipse.getB());
+        Eigen::Map<Eigen::Matrix2Xf> output_points(vertices + 2 * point_count * i, 2, point_count);
+        output_points.noalias() = (ellipse.getRotationMatrix() * axes.asDiagonal()).cast<float>() * unit_points;
+        output_points.colwise() += ellipse.getPositionVector().cast<float>();
+    }
+}
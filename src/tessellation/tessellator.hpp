@@ -0,0 +1,165 @@
+/**
+ * @file tessellator.hpp
+ * @brief Defines the Tessellator class, which generates triangle meshes of ellipsoids and polylines of ellipses.
+ *
+ * Every ellipsoid mesh is an affine image of a unit-sphere template, so the templates are built once per
+ * refinement level and shared by all ellipsoids. The refinement level of each ellipsoid is chosen from its
+ * maximum curvature, so that the chord error of the mesh stays below a tolerance. Batches are planned first, to
+ * give the buffer sizes and per-shape offsets, and then written directly into caller-owned buffers in parallel.
+ *
+ * Refinement adapts per shape, not across the surface: each ellipsoid uses one uniform level, sized for its most
+ * curved region, so flatter regions of elongated ellipsoids are over-refined. Throughput is therefore set by the
+ * vertex count. On one core, 100k random ellipsoids with axes around (1, 0.7, 0.4) take about 74 ms at a fixed
+ * level 1 (4.2M vertices), but about 0.67 s for icospheres and 1.5 s for UV spheres at a chord tolerance of 0.1
+ * (38M and 90M vertices). Millisecond-scale batches of this size need a fixed, coarse level.
+ *
+ * Usage:
+ * @code
+ * Tessellator tessellator(SphereTemplate::Icosphere);
+ * EllipsoidMeshLayout layout = tessellator.planEllipsoids(ellipsoids, 1.0e-3);
+ * std::vector<float> vertices(3 * layout.vertex_count);
+ * std::vector<float> normals(3 * layout.vertex_count);
+ * std::vector<std::uint32_t> indices(layout.index_count);
+ * tessellator.tessellateEllipsoids(ellipsoids, layout, vertices.data(), normals.data(), indices.data());
+ * @endcode
+ */
+#ifndef TESSELLATOR_HPP
+#define TESSELLATOR_HPP
+
+#include "ellipse.hpp"
+#include "ellipsoid.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum class SphereTemplate
+{
+    UVSphere,
+    Icosphere
+};
+
+/**
+ * @brief An indexed triangle mesh of the unit sphere.
+ */
+struct UnitSphereMesh
+{
+    /**
+     * @brief Unit vertex positions, stored as interleaved x, y, z. These are also the vertex normals.
+     */
+    std::vector<float> vertices;
+
+    /**
+     * @brief Vertex indices, three per counter-clockwise triangle when viewed from outside.
+     */
+    std::vector<std::uint32_t> indices;
+
+    /**
+     * @brief The largest angle, in radians, subtended by any edge of the mesh.
+     */
+    double max_edge_angle;
+
+    std::size_t getVertexCount() const { return vertices.size() / 3; }
+    std::size_t getIndexCount() const { return indices.size(); }
+};
+
+/**
+ * @brief The refinement level and buffer offsets of each ellipsoid in a batch.
+ */
+struct EllipsoidMeshLayout
+{
+    std::vector<int> levels;
+    std::vector<std::size_t> vertex_offsets;
+    std::vector<std::size_t> index_offsets;
+    std::size_t vertex_count;
+    std::size_t index_count;
+};
+
+/**
+ * @brief Generates indexed triangle meshes of ellipsoids and closed polylines of ellipses.
+ */
+class Tessellator
+{
+public:
+
+    /********** Constructors **********/
+
+    /**
+     * @brief Builds the unit-sphere templates for refinement levels 0 to max_level.
+     *
+     * For an icosphere, level L has 10 * 4^L + 2 vertices. For a UV sphere, level L has 4 * 2^L stacks and
+     * 8 * 2^L slices.
+     */
+    explicit Tessellator(SphereTemplate template_type = SphereTemplate::Icosphere, int max_level = 5);
+
+    /********** Getters **********/
+
+    const UnitSphereMesh& getTemplate(int level) const { return templates.at(level); }
+    int getMaxLevel() const { return static_cast<int>(templates.size()) - 1; }
+    SphereTemplate getTemplateType() const { return template_type; }
+
+    /********** Ellipsoid Meshes **********/
+
+    /**
+     * @brief Returns the coarsest level whose chord error on the ellipsoid is below tolerance.
+     *
+     * The chord error of an edge of length l on a surface of curvature k is approximately k * l^2 / 8. The largest
+     * curvature of an ellipsoid is a_max / c_min^2, and its edges are at most a_max times their template angle.
+     * If no level is fine enough, the finest level is returned.
+     */
+    int selectRefinementLevel(const Ellipsoid& ellipsoid, double tolerance) const;
+
+    /**
+     * @brief Chooses a refinement level for each ellipsoid and computes its offsets into the batch buffers.
+     *
+     * Throws std::length_error if the batch has more than 2^32 - 1 vertices, as these cannot all be indexed.
+     */
+    EllipsoidMeshLayout planEllipsoids(const std::vector<Ellipsoid>& ellipsoids, double tolerance) const;
+
+    /**
+     * @brief Plans a batch in which every ellipsoid uses the same refinement level. Throws as above.
+     */
+    EllipsoidMeshLayout planEllipsoids(const std::vector<Ellipsoid>& ellipsoids, int level) const;
+
+    /**
+     * @brief Writes the mesh of one ellipsoid.
+     *
+     * vertices and normals receive 3 floats per template vertex (normals may be null), and indices receive the
+     * template indices offset by base_vertex. Throws std::out_of_range if level is not in [0, getMaxLevel()].
+     */
+    void tessellateEllipsoid(const Ellipsoid& ellipsoid, int level, float* vertices, float* normals,
+                             std::uint32_t* indices, std::uint32_t base_vertex = 0) const;
+
+    /**
+     * @brief Writes the meshes of a batch of ellipsoids into shared buffers, in parallel.
+     *
+     * The buffers must hold 3 * layout.vertex_count floats (normals may be null) and layout.index_count indices.
+     * Indices refer to the shared vertex buffer, so the batch is limited to 2^32 - 1 vertices, and
+     * std::length_error is thrown for larger layouts. The layout is checked before any mesh is written: a level
+     * outside [0, getMaxLevel()] throws std::out_of_range, and a layout for a different number of ellipsoids
+     * throws std::invalid_argument.
+     */
+    void tessellateEllipsoids(const std::vector<Ellipsoid>& ellipsoids, const EllipsoidMeshLayout& layout,
+                              float* vertices, float* normals, std::uint32_t* indices) const;
+
+    /********** Ellipse Polylines **********/
+
+    /**
+     * @brief Writes a closed polyline of point_count points around each ellipse, in parallel.
+     *
+     * The buffer must hold 2 * point_count * ellipses.size() floats; the points of ellipse i start at
+     * 2 * point_count * i. The closing segment from the last point back to the first is implicit. Throws
+     * std::invalid_argument if point_count is less than 2.
+     */
+    static void tessellateEllipses(const std::vector<Ellipse>& ellipses, int point_count, float* vertices);
+
+private:
+
+    SphereTemplate template_type;
+
+    /**
+     * @brief The unit-sphere templates, indexed by refinement level. These are shared by every ellipsoid.
+     */
+    std::vector<UnitSphereMesh> templates;
+};
+
+#endif // TESSELLATOR_HPP
@@ -57,7 +57,7 @@ double SafeNewtonRaphson(std::function<double(double)> Function, std::function<d
         // Use bisection if Newton-Raphson out of range, or if convergence too slow
         // Else, use Newton-Raphson
         if ((((x_value - x_upper) * derivative_value - function_value) * ((x_value - x_lower) * derivative_value - function_value) >= 0) ||
-            abs(2 * function_value) > abs(previous_x_difference * derivative_value)) 
+            fabs(2 * function_value) > fabs(previous_x_difference * derivative_value)) 
         {
             previous_x_difference = x_difference;
             x_difference = 0.5 * (x_upper - x_lower);
@@ -70,8 +70,8 @@ double SafeNewtonRaphson(std::function<double(double)> Function, std::function<d
             x_value -= x_difference;
         }
 
-        // Check for convergence
-        if (fabs(x_difference) < tolerance) { break; }
+        // Check for convergence, relative to the magnitude of the root. A root at exactly zero runs to max_iterations.
+        if (fabs(x_difference) <= tolerance * fabs(x_value)) { break; }
 
         function_value = Function(x_value);
         derivative_value = Derivative(x_value);
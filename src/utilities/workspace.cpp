@@ -0,0 +1,79 @@
+#include "workspace.hpp"
+#include <algorithm>
+#include <limits>
+#include <new>
+
+namespace
+{
+    std::size_t roundUpToAlignment(std::size_t bytes)
+    {
+        return (bytes + Workspace::alignment - 1) & ~(Workspace::alignment - 1);
+    }
+}
+
+Workspace::Workspace(std::size_t initial_capacity)
+{
+    blocks.reserve(8);
+    addBlock(initial_capacity);
+}
+
+void Workspace::reset()
+{
+    if (blocks.empty()) { return; }
+    if (blocks.size() > 1)
+    {
+        std::size_t total_capacity = getCapacity();
+        blocks.clear();
+        addBlock(total_capacity);
+    }
+    blocks.back().used = 0;
+}
+
+void Workspace::reserve(std::size_t capacity)
+{
+    if (getCapacity() < capacity) { addBlock(capacity - getCapacity()); }
+}
+
+std::size_t Workspace::getCapacity() const
+{
+    std::size_t capacity = 0;
+    for (const Block& block : blocks) { capacity += block.size; }
+    return capacity;
+}
+
+std::size_t Workspace::getUsedBytes() const
+{
+    std::size_t used = 0;
+    for (const Block& block : blocks) { used += block.used; }
+    return used;
+}
+
+void* Workspace::allocateBytes(std::size_t bytes)
+{
+    if (bytes > std::numeric_limits<std::size_t>::max() - alignment) { throw std::bad_array_new_length(); }
+    bytes = roundUpToAlignment(std::max<std::size_t>(bytes, 1));
+
+    // A moved-from workspace has no blocks until its next allocation
+    Block* block = blocks.empty() ? nullptr : &blocks.back();
+    if (block == nullptr || block->size - block->used < bytes)
+    {
+        // Grow geometrically so that a frame needs only a handful of extra blocks
+        addBlock(block == nullptr ? bytes : std::max(bytes, 2 * block->size));
+        block = &blocks.back();
+    }
+
+    void* pointer = block->data.get() + block->used;
+    block->used += bytes;
+    return pointer;
+}
+
+void Workspace::addBlock(std::size_t size)
+{
+    size = roundUpToAlignment(std::max<std::size_t>(size, alignment));
+
+    Block block;
+    block.data.reset(static_cast<std::byte*>(::operator new[](size, std::align_val_t(alignment))));
+    block.size = size;
+    block.used = 0;
+    blocks.push_back(std::move(block));
+}
@@ -0,0 +1,126 @@
+/**
+ * @file workspace.hpp
+ * @brief Defines the Workspace class, an arena used for batch query results and solver scratch buffers.
+ *
+ * Batch queries on Ellipsoid and Ellipse objects take a Workspace and return views into memory
+ * owned by it. The caller resets the workspace once per frame; after the first frame has grown the
+ * arena to its high-water mark, subsequent frames perform no heap allocations.
+ *
+ * Usage:
+ * @code
+ * Workspace workspace;
+ * for (each frame)
+ * {
+ *     workspace.reset();
+ *     auto closest_points = ellipsoid.computeClosestSurfacePoints(query_points, workspace);
+ * }
+ * @endcode
+ */
+#ifndef WORKSPACE_HPP
+#define WORKSPACE_HPP
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief A reusable arena of aligned memory blocks.
+ *
+ * Allocations are bump-pointer allocations from the current block. When a block is exhausted a new one
+ * is added; on the next reset() all blocks are coalesced into a single block large enough for the
+ * previous frame, so steady-state use never touches the heap.
+ */
+class Workspace
+{
+public:
+
+    /**
+     * @brief Alignment, in bytes, of every allocation. Suitable for AVX-512 loads and stores.
+     */
+    static constexpr std::size_t alignment = 64;
+
+    /********** Constructors **********/
+
+    /**
+     * @brief Creates a workspace with an initial capacity.
+     * @param initial_capacity Size of the first block, in bytes.
+     */
+    explicit Workspace(std::size_t initial_capacity = 1 << 16);
+
+    Workspace(const Workspace&) = delete;
+    Workspace& operator=(const Workspace&) = delete;
+
+    /**
+     * @brief Moves the blocks of another workspace. The moved-from workspace is left empty, and allocates a new
+     * block on its next allocation.
+     */
+    Workspace(Workspace&&) = default;
+    Workspace& operator=(Workspace&&) = default;
+
+    /********** Allocation **********/
+
+    /**
+     * @brief Returns uninitialised, aligned storage for count objects of type T.
+     *
+     * The storage remains valid until the next call to reset(). Only trivially destructible types may be
+     * allocated, as the workspace never runs destructors. Throws std::bad_array_new_length if the size of
+     * the storage overflows std::size_t.
+     */
+    template <typename T>
+    T* allocate(std::size_t count)
+    {
+        static_assert(std::is_trivially_destructible<T>::value, "Workspace storage is never destroyed");
+        static_assert(alignof(T) <= alignment, "Type is over-aligned for the workspace");
+        if (count > std::numeric_limits<std::size_t>::max() / sizeof(T)) { throw std::bad_array_new_length(); }
+        return static_cast<T*>(allocateBytes(count * sizeof(T)));
+    }
+
+    /**
+     * @brief Releases all allocations made since the last reset.
+     *
+     * If the previous frame needed more than one block, the blocks are replaced by a single block
+     * with their combined capacity.
+     */
+    void reset();
+
+    /**
+     * @brief Ensures that at least capacity bytes can be allocated after the next reset without growing.
+     */
+    void reserve(std::size_t capacity);
+
+    /********** Getters **********/
+
+    std::size_t getCapacity() const;
+    std::size_t getUsedBytes() const;
+    std::size_t getBlockCount() const { return blocks.size(); }
+
+private:
+
+    struct AlignedDeleter
+    {
+        void operator()(std::byte* data) const
+        {
+            ::operator delete[](data, std::align_val_t(alignment));
+        }
+    };
+
+    struct Block
+    {
+        std::unique_ptr<std::byte[], AlignedDeleter> data;
+        std::size_t size;
+        std::size_t used;
+    };
+
+    void* allocateBytes(std::size_t bytes);
+    void addBlock(std::size_t size);
+
+    /**
+     * @brief The memory blocks of the arena. Allocation always happens from the last block.
+     */
+    std::vector<Block> blocks;
+};
+
+#endif // WORKSPACE_HPP
@@ -0,0 +1,205 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "ellipsoid.hpp"
+#include "ellipsoid_catalog.hpp"
+#include "workspace.hpp"
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    std::string getTemporaryPath(const std::string& name)
+    {
+        return (std::filesystem::temp_directory_path() / name).string();
+    }
+
+    std::vector<Ellipsoid> generateEllipsoids(std::size_t count, std::mt19937_64& generator)
+    {
+        std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+        std::vector<Ellipsoid> ellipsoids;
+        for (std::size_t i = 0; i < count; i++)
+        {
+            double a = 2.0 + uniform(generator);
+            double b = (i % 4 == 0) ? a : 1.5 + 0.5 * uniform(generator);
+            double c = (i % 4 <= 1) ? b : 0.75 + 0.25 * uniform(generator);
+            Ellipsoid ellipsoid(a, b, c);
+            Eigen::Vector3d position(10.0 * uniform(generator), 10.0 * uniform(generator), 10.0 * uniform(generator));
+            Eigen::Matrix3d rotation = Eigen::Quaterniond(uniform(generator), uniform(generator), uniform(generator),
+                                                          uniform(generator)).normalized().toRotationMatrix();
+            ellipsoid.setPositionVector(position);
+            ellipsoid.setRotationMatrix(rotation);
+            ellipsoids.push_back(ellipsoid);
+        }
+        return ellipsoids;
+    }
+
+    void writeBytes(const std::string& path, const std::vector<char>& bytes)
+    {
+        std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+        stream.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    std::vector<char> readBytes(const std::string& path)
+    {
+        std::ifstream stream(path, std::ios::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    }
+}
+
+TEST_CASE("CatalogRoundTrip")
+{
+    std::mt19937_64 generator(11);
+    std::vector<Ellipsoid> ellipsoids = generateEllipsoids(1000, generator);
+    std::string path = getTemporaryPath("eorl_test_round_trip.eorl");
+    REQUIRE(EllipsoidCatalog::write(path, ellipsoids));
+
+    EllipsoidCatalog catalog;
+    REQUIRE(catalog.open(path));
+    REQUIRE(catalog.getEllipsoidCount() == ellipsoids.size());
+    REQUIRE(reinterpret_cast<std::uintptr_t>(catalog.getSemiAxes(0).data()) % EllipsoidCatalog::alignment == 0);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(catalog.getBoundingRadii().data()) % EllipsoidCatalog::alignment == 0);
+
+    for (std::size_t i = 0; i < ellipsoids.size(); i++)
+    {
+        const Ellipsoid& expected = ellipsoids[i];
+        Ellipsoid loaded = catalog.getEllipsoid(i);
+        REQUIRE(loaded.getA() == expected.getA());
+        REQUIRE(loaded.getB() == expected.getB());
+        REQUIRE(loaded.getC() == expected.getC());
+        REQUIRE(loaded.getPositionVector() == expected.getPositionVector());
+        REQUIRE(loaded.getRotationMatrix() == expected.getRotationMatrix());
+        REQUIRE(loaded.getForm() == expected.getForm());
+        REQUIRE(catalog.getForm(i) == expected.getForm());
+
+        REQUIRE(catalog.getInverseSquaredSemiAxes(2)[i] == 1.0 / (expected.getC() * expected.getC()));
+        REQUIRE(catalog.getBoundingRadii()[i] == std::max({expected.getA(), expected.getB(), expected.getC()}));
+    }
+
+    catalog.close();
+    REQUIRE(!catalog.isOpen());
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("CatalogContainment")
+{
+    std::mt19937_64 generator(13);
+    std::vector<Ellipsoid> ellipsoids = generateEllipsoids(200, generator);
+    std::string path = getTemporaryPath("eorl_test_containment.eorl");
+    REQUIRE(EllipsoidCatalog::write(path, ellipsoids));
+
+    EllipsoidCatalog catalog;
+    REQUIRE(catalog.open(path));
+    Workspace workspace;
+    std::uniform_real_distribution<double> uniform(-10.0, 10.0);
+
+    int inside_count = 0;
+    for (int trial = 0; trial < 100; trial++)
+    {
+        Eigen::Vector3d point(uniform(generator), uniform(generator), uniform(generator));
+        workspace.reset();
+        ArrayXbMap inside = catalog.computeContainment(point, workspace);
+        for (std::size_t i = 0; i < ellipsoids.size(); i++)
+        {
+            double signed_distance = ellipsoids[i].computeSignedDistance(point);
+            if (std::abs(signed_distance) > 1.0e-9)
+            {
+                REQUIRE(inside[i] == (signed_distance < 0.0));
+            }
+            inside_count += inside[i];
+        }
+    }
+    REQUIRE(inside_count > 0);
+
+    catalog.close();
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("CatalogRejectsInvalidFiles")
+{
+    std::mt19937_64 generator(17);
+    std::string path = getTemporaryPath("eorl_test_invalid.eorl");
+    std::string corrupt_path = getTemporaryPath("eorl_test_corrupt.eorl");
+    REQUIRE(EllipsoidCatalog::write(path, generateEllipsoids(10, generator)));
+    std::vector<char> bytes = readBytes(path);
+
+    EllipsoidCatalog catalog;
+    REQUIRE(!catalog.open(getTemporaryPath("eorl_test_missing.eorl")));
+
+    std::vector<char> bad_magic = bytes;
+    bad_magic[0] = 'X';
+    writeBytes(corrupt_path, bad_magic);
+    REQUIRE(!catalog.open(corrupt_path));
+
+    std::vector<char> bad_version = bytes;
+    bad_version[8] = 2;
+    writeBytes(corrupt_path, bad_version);
+    REQUIRE(!catalog.open(corrupt_path));
+
+    // The form array offset is stored little-endian in the header, after the magic, version, array count and count
+    std::size_t form_offset_position = 24 + 8 * static_cast<std::size_t>(CatalogArray::Form);
+    std::size_t form_offset = 0;
+    for (int k = 7; k >= 0; k--)
+    {
+        form_offset = (form_offset << 8) | static_cast<unsigned char>(bytes[form_offset_position + k]);
+    }
+    std::vector<char> bad_form = bytes;
+    bad_form[form_offset + 3] = 4;
+    writeBytes(corrupt_path, bad_form);
+    REQUIRE(!catalog.open(corrupt_path));
+
+    std::vector<char> truncated(bytes.begin(), bytes.end() - 1);
+    writeBytes(corrupt_path, truncated);
+    REQUIRE(!catalog.open(corrupt_path));
+
+    REQUIRE(catalog.open(path));
+    REQUIRE(catalog.getEllipsoidCount() == 10);
+
+    // An empty catalog is still a valid file
+    REQUIRE(EllipsoidCatalog::write(path, {}));
+    REQUIRE(catalog.open(path));
+    REQUIRE(catalog.getEllipsoidCount() == 0);
+
+    catalog.close();
+    std::filesystem::remove(path);
+    std::filesystem::remove(corrupt_path);
+}
+
+TEST_CASE("CatalogTextConversion")
+{
+    std::string path = getTemporaryPath("eorl_test_catalog.txt");
+    {
+        std::ofstream stream(path);
+        stream << "# a b c x y z [rotation]\n";
+        stream << "3 2 1 0.5 -1 2\n";
+        stream << "\n";
+        stream << "2 2 2 0 0 0  0 -1 0  1 0 0  0 0 1\n";
+    }
+
+    std::vector<Ellipsoid> ellipsoids;
+    std::size_t line_number;
+    REQUIRE(EllipsoidCatalog::readText(path, ellipsoids, line_number));
+    REQUIRE(ellipsoids.size() == 2);
+    REQUIRE(ellipsoids[0].getForm() == EllipsoidForm::Triaxial);
+    REQUIRE(ellipsoids[0].getPositionVector() == Eigen::Vector3d(0.5, -1.0, 2.0));
+    REQUIRE(ellipsoids[1].getForm() == EllipsoidForm::Sphere);
+    REQUIRE(ellipsoids[1].getRotationMatrix()(0, 1) == -1.0);
+    REQUIRE(ellipsoids[1].getRotationMatrix()(1, 0) == 1.0);
+
+    {
+        std::ofstream stream(path);
+        stream << "3 2 1 0 0 0\n";
+        stream << "3 2 1 0 0\n";
+    }
+    ellipsoids.clear();
+    REQUIRE(!EllipsoidCatalog::readText(path, ellipsoids, line_number));
+    REQUIRE(line_number == 2);
+
+    std::filesystem::remove(path);
+}
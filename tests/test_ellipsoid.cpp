@@ -1,6 +1,32 @@
 #include <catch2/catch_test_macros.hpp>
 
 #include "ellipsoid.hpp"
+#include "newton_raphson.hpp"
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <cmath>
+
+namespace
+{
+    /**
+     * @brief Checks that the closest surface point lies on the ellipsoid, with the query point along its normal.
+     */
+    void checkClosestSurfacePoint(const Ellipsoid& ellipsoid, const Eigen::Vector3d& query_point)
+    {
+        Eigen::Matrix3d rotation = ellipsoid.getRotationMatrix();
+        Eigen::Vector3d position = ellipsoid.getPositionVector();
+        Eigen::Vector3d inverse_axes_squared(1.0 / (ellipsoid.getA() * ellipsoid.getA()),
+                                             1.0 / (ellipsoid.getB() * ellipsoid.getB()),
+                                             1.0 / (ellipsoid.getC() * ellipsoid.getC()));
+        Eigen::Vector3d contact_point = ellipsoid.computeClosestSurfacePoint(query_point);
+
+        Eigen::Vector3d local_contact = rotation.transpose() * (contact_point - position);
+        Eigen::Vector3d local_normal = local_contact.cwiseProduct(inverse_axes_squared).normalized();
+        Eigen::Vector3d local_offset = rotation.transpose() * (query_point - contact_point);
+        REQUIRE(std::abs(local_contact.cwiseProduct(local_contact).dot(inverse_axes_squared) - 1.0) < 1.0e-10);
+        REQUIRE(local_offset.cross(local_normal).norm() < 1.0e-9 * (ellipsoid.getA() + local_offset.norm()));
+    }
+}
 
 TEST_CASE("EllipsoidConstruction")
 {
@@ -15,4 +41,128 @@ TEST_CASE("EllipsoidConstruction")
 
     ellipsoid.setPositionVector(0.0, 0.0, 1.0);
     REQUIRE(ellipsoid.hasTransform() == true);
-}
\ No newline at end of file
+}
+
+TEST_CASE("EllipsoidForm")
+{
+    REQUIRE(Ellipsoid(2.0, 2.0, 2.0).getForm() == EllipsoidForm::Sphere);
+    REQUIRE(Ellipsoid(2.0, 2.0, 1.0).getForm() == EllipsoidForm::Oblate);
+    REQUIRE(Ellipsoid(1.0, 2.0, 1.0).getForm() == EllipsoidForm::Prolate);
+    REQUIRE(Ellipsoid(3.0, 2.0, 3.0).getForm() == EllipsoidForm::Oblate);
+    REQUIRE(Ellipsoid(3.0, 2.0, 1.0).getForm() == EllipsoidForm::Triaxial);
+
+    Ellipsoid ellipsoid = Ellipsoid(3.0, 2.0, 1.0);
+    ellipsoid.setSemiAxes(1.0, 1.0, 1.0);
+    REQUIRE(ellipsoid.getForm() == EllipsoidForm::Sphere);
+}
+
+TEST_CASE("ClosestSurfacePointCanonicalSpecialCases")
+{
+    Ellipsoid ellipsoid = Ellipsoid(3.0, 2.0, 1.0);
+
+    // Query points on the axes, outside the ellipsoid
+    REQUIRE((ellipsoid.computeClosestSurfacePoint(Eigen::Vector3d(0.0, 0.0, 5.0)) - Eigen::Vector3d(0.0, 0.0, 1.0)).norm() < 1.0e-12);
+    REQUIRE((ellipsoid.computeClosestSurfacePoint(Eigen::Vector3d(-7.0, 0.0, 0.0)) - Eigen::Vector3d(-3.0, 0.0, 0.0)).norm() < 1.0e-12);
+
+    // The centre is closest to the ends of the minor axis
+    REQUIRE(std::abs(std::abs(ellipsoid.computeClosestSurfacePoint(Eigen::Vector3d::Zero())[2]) - 1.0) < 1.0e-12);
+
+    // A point on the surface is its own closest point
+    Eigen::Vector3d surface_point(3.0 * std::cos(0.3) * std::cos(0.2), 2.0 * std::cos(0.3) * std::sin(0.2), std::sin(0.3));
+    REQUIRE((ellipsoid.computeClosestSurfacePoint(surface_point) - surface_point).norm() < 1.0e-12);
+}
+
+TEST_CASE("ClosestSurfacePointOrthogonality")
+{
+    Ellipsoid ellipsoid = Ellipsoid(3.0, 2.0, 1.0);
+    Eigen::Matrix3d rotation = Eigen::AngleAxisd(0.7, Eigen::Vector3d(1.0, 2.0, -1.0).normalized()).toRotationMatrix();
+    Eigen::Vector3d position(1.0, -2.0, 0.5);
+    ellipsoid.setRotationMatrix(rotation);
+    ellipsoid.setPositionVector(position);
+    Eigen::Vector3d inverse_axes_squared(1.0 / 9.0, 1.0 / 4.0, 1.0);
+
+    Eigen::Matrix3Xd query_points = Eigen::Matrix3Xd::Random(3, 200) * 5.0;
+    query_points.colwise() += position;
+    for (Eigen::Index i = 0; i < query_points.cols(); i++)
+    {
+        Eigen::Vector3d query_point = query_points.col(i);
+        Eigen::Vector3d contact_point = ellipsoid.computeClosestSurfacePoint(query_point);
+
+        // The contact point lies on the surface, and the query point lies along the surface normal
+        Eigen::Vector3d local_contact = rotation.transpose() * (contact_point - position);
+        Eigen::Vector3d local_normal = local_contact.cwiseProduct(inverse_axes_squared).normalized();
+        Eigen::Vector3d local_offset = rotation.transpose() * (query_point - contact_point);
+        REQUIRE(std::abs(local_contact.cwiseProduct(local_contact).dot(inverse_axes_squared) - 1.0) < 1.0e-10);
+        REQUIRE(local_offset.cross(local_normal).norm() < 1.0e-9 * (1.0 + local_offset.norm()));
+    }
+}
+
+TEST_CASE("ClosestSurfacePointNearPrincipalPlane")
+{
+    // A query a hair off the plane of the two longer axes must not start the root search on the pole of F
+    Ellipsoid ellipsoid = Ellipsoid(3.0, 2.0, 1.0);
+    Eigen::Vector3d contact_point = ellipsoid.computeClosestSurfacePoint(Eigen::Vector3d(4.0, 3.0, 1.0e-17));
+    Eigen::Vector3d in_plane_contact = ellipsoid.computeClosestSurfacePoint(Eigen::Vector3d(4.0, 3.0, 0.0));
+    REQUIRE((contact_point - in_plane_contact).norm() < 1.0e-12);
+
+    Ellipsoid spheroid = Ellipsoid(2.0, 2.0, 1.0);
+    contact_point = spheroid.computeClosestSurfacePoint(Eigen::Vector3d(3.0, 4.0, 1.0e-17));
+    REQUIRE((contact_point - Eigen::Vector3d(1.2, 1.6, 0.0)).norm() < 1.0e-12);
+}
+
+TEST_CASE("ClosestSurfacePointLargeRoots")
+{
+    // Large or elongated ellipsoids put the root of Eberly's function far from zero, where the safe Newton
+    // iteration has to stop on a step tolerance relative to the root
+    Ellipsoid spheroid = Ellipsoid(6378137.0, 6378137.0, 6356752.314245);
+    Eigen::Matrix3d rotation = Eigen::AngleAxisd(0.4, Eigen::Vector3d(-1.0, 0.5, 2.0).normalized()).toRotationMatrix();
+    Eigen::Vector3d position(1.0e6, -2.0e6, 3.0e5);
+    spheroid.setRotationMatrix(rotation);
+    spheroid.setPositionVector(position);
+
+    Ellipsoid elongated = Ellipsoid(100.0, 1.0, 0.1);
+    elongated.setRotationMatrix(rotation);
+
+    Eigen::Matrix3Xd query_directions = Eigen::Matrix3Xd::Random(3, 100);
+    for (Eigen::Index i = 0; i < query_directions.cols(); i++)
+    {
+        Eigen::Vector3d direction = query_directions.col(i);
+        checkClosestSurfacePoint(spheroid, position + 2.0e7 * direction);
+        checkClosestSurfacePoint(elongated, 300.0 * direction);
+
+        // Query points in a principal plane reduce to the closest point on an ellipse
+        direction[2] = 0.0;
+        checkClosestSurfacePoint(spheroid, position + rotation * (2.0e7 * direction));
+        checkClosestSurfacePoint(elongated, rotation * (300.0 * direction));
+    }
+
+    // Points on the axes, far outside
+    REQUIRE((elongated.computeClosestSurfacePoint(rotation * Eigen::Vector3d(0.0, 0.0, 1.0e4)) -
+             rotation * Eigen::Vector3d(0.0, 0.0, 0.1)).norm() < 1.0e-12);
+    REQUIRE((spheroid.computeClosestSurfacePoint(position + rotation * Eigen::Vector3d(4.0e7, 0.0, 0.0)) -
+             (position + rotation * Eigen::Vector3d(6378137.0, 0.0, 0.0))).norm() < 1.0e-6);
+}
+
+TEST_CASE("SafeNewtonRaphsonConvergesForLargeRoots")
+{
+    // F(s) = 2 (r / (s + r))^2 - 1 has its root at s = (sqrt(2) - 1) r
+    for (double ratio : {1.0, 1.0e3, 1.0e6, 1.0e9})
+    {
+        int evaluation_count = 0;
+        auto function = [&](double s)
+        {
+            evaluation_count++;
+            double term = ratio / (s + ratio);
+            return 2.0 * term * term - 1.0;
+        };
+        auto derivative = [&](double s)
+        {
+            double term = ratio / (s + ratio);
+            return -4.0 * term * term / (s + ratio);
+        };
+
+        double root = SafeNewtonRaphson(function, derivative, 0.0, 2.0 * ratio, 0.0);
+        REQUIRE(std::abs(root - (std::sqrt(2.0) - 1.0) * ratio) < 1.0e-14 * ratio);
+        REQUIRE(evaluation_count < 20);
+    }
+}
@@ -0,0 +1,101 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "ellipsoid.hpp"
+#include "ellipsoid_fitter.hpp"
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <cmath>
+#include <random>
+
+namespace
+{
+    Eigen::Matrix3Xd sampleSurfacePoints(const Eigen::Vector3d& axes, const Eigen::Matrix3d& rotation,
+                                         const Eigen::Vector3d& position, Eigen::Index count, double noise)
+    {
+        std::mt19937 generator(42);
+        std::normal_distribution<double> normal(0.0, 1.0);
+
+        Eigen::Matrix3Xd points(3, count);
+        for (Eigen::Index i = 0; i < count; i++)
+        {
+            Eigen::Vector3d direction(normal(generator), normal(generator), normal(generator));
+            Eigen::Vector3d jitter(normal(generator), normal(generator), normal(generator));
+            points.col(i) = rotation * axes.cwiseProduct(direction.normalized()) + position + noise * jitter;
+        }
+        return points;
+    }
+
+    const Eigen::Vector3d true_axes(5.0, 3.0, 2.0);
+    const Eigen::Matrix3d true_rotation = Eigen::AngleAxisd(0.6, Eigen::Vector3d(1.0, -1.0, 2.0).normalized()).toRotationMatrix();
+    const Eigen::Vector3d true_position(10.0, -4.0, 7.0);
+
+    void requireMatchesTruth(const Ellipsoid& ellipsoid, double tolerance)
+    {
+        REQUIRE(std::abs(ellipsoid.getA() - true_axes[0]) < tolerance);
+        REQUIRE(std::abs(ellipsoid.getB() - true_axes[1]) < tolerance);
+        REQUIRE(std::abs(ellipsoid.getC() - true_axes[2]) < tolerance);
+        REQUIRE((ellipsoid.getPositionVector() - true_position).norm() < tolerance);
+
+        // Axis directions are only defined up to sign
+        Eigen::Matrix3d rotation = ellipsoid.getRotationMatrix();
+        REQUIRE(std::abs(rotation.determinant() - 1.0) < 1.0e-12);
+        for (int i = 0; i < 3; i++)
+        {
+            REQUIRE(std::abs(std::abs(rotation.col(i).dot(true_rotation.col(i))) - 1.0) < tolerance);
+        }
+    }
+}
+
+TEST_CASE("AlgebraicFitExactPoints")
+{
+    Eigen::Matrix3Xd points = sampleSurfacePoints(true_axes, true_rotation, true_position, 1000, 0.0);
+
+    EllipsoidFitter fitter;
+    fitter.addPoints(points);
+    Ellipsoid ellipsoid;
+    REQUIRE(fitter.fitAlgebraic(ellipsoid));
+    REQUIRE(ellipsoid.getForm() == EllipsoidForm::Triaxial);
+    requireMatchesTruth(ellipsoid, 1.0e-6);
+}
+
+TEST_CASE("AlgebraicFitIncrementalUpdates")
+{
+    Eigen::Matrix3Xd points = sampleSurfacePoints(true_axes, true_rotation, true_position, 10000, 0.01);
+
+    EllipsoidFitter batch_fitter;
+    batch_fitter.addPoints(points);
+
+    EllipsoidFitter streaming_fitter;
+    for (Eigen::Index i = 0; i < 5; i++) { streaming_fitter.addPoint(points.col(i)); }
+    streaming_fitter.addPoints(points.rightCols(points.cols() - 5));
+    REQUIRE(streaming_fitter.getPointCount() == batch_fitter.getPointCount());
+
+    Ellipsoid batch_ellipsoid;
+    Ellipsoid streaming_ellipsoid;
+    REQUIRE(batch_fitter.fitAlgebraic(batch_ellipsoid));
+    REQUIRE(streaming_fitter.fitAlgebraic(streaming_ellipsoid));
+    REQUIRE(std::abs(batch_ellipsoid.getA() - streaming_ellipsoid.getA()) < 1.0e-8);
+    REQUIRE((batch_ellipsoid.getPositionVector() - streaming_ellipsoid.getPositionVector()).norm() < 1.0e-8);
+
+    streaming_fitter.reset();
+    REQUIRE(streaming_fitter.getPointCount() == 0);
+    REQUIRE(streaming_fitter.fitAlgebraic(streaming_ellipsoid) == false);
+}
+
+TEST_CASE("GeometricRefinementNoisyPoints")
+{
+    Eigen::Matrix3Xd points = sampleSurfacePoints(true_axes, true_rotation, true_position, 20000, 0.05);
+
+    EllipsoidFitter fitter;
+    fitter.addPoints(points);
+    Ellipsoid ellipsoid;
+    REQUIRE(fitter.fitAlgebraic(ellipsoid));
+    double algebraic_rms = EllipsoidFitter::computeRmsDistance(points, ellipsoid);
+
+    REQUIRE(EllipsoidFitter::refineGeometric(points, ellipsoid));
+    double geometric_rms = EllipsoidFitter::computeRmsDistance(points, ellipsoid);
+
+    REQUIRE(geometric_rms <= algebraic_rms);
+    REQUIRE(geometric_rms < 0.06);
+    requireMatchesTruth(ellipsoid, 0.01);
+}
@@ -0,0 +1,207 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "ellipsoid.hpp"
+#include "geodesic_solver.hpp"
+#include "workspace.hpp"
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+namespace
+{
+    const double pi = std::acos(-1.0);
+
+    /**
+     * @brief Returns the surface point at reduced latitude and longitude, with the c axis as the symmetry axis.
+     */
+    Eigen::Vector3d computeSurfacePoint(const Eigen::Vector3d& axes, double latitude, double longitude)
+    {
+        return Eigen::Vector3d(axes[0] * std::cos(latitude) * std::cos(longitude),
+                               axes[1] * std::cos(latitude) * std::sin(longitude),
+                               axes[2] * std::sin(latitude));
+    }
+
+    bool isRelativelyClose(double value, double expected, double tolerance)
+    {
+        return std::abs(value - expected) <= tolerance * std::abs(expected);
+    }
+}
+
+TEST_CASE("GeodesicSphere")
+{
+    Ellipsoid sphere = Ellipsoid(2.0, 2.0, 2.0);
+    sphere.setPositionVector(1.0, 1.0, 1.0);
+    GeodesicSolver solver(sphere);
+
+    Eigen::Vector3d offset(1.0, 1.0, 1.0);
+    Eigen::Vector3d start = Eigen::Vector3d(2.0, 0.0, 0.0) + offset;
+    Eigen::Vector3d end = Eigen::Vector3d(0.0, 2.0 * std::cos(0.3), 2.0 * std::sin(0.3)) + offset;
+    REQUIRE(isRelativelyClose(solver.computeDistance(start, end), pi, 1.0e-14));
+    REQUIRE(isRelativelyClose(sphere.computeGeodesicDistance(start, end), pi, 1.0e-14));
+    REQUIRE(isRelativelyClose(solver.computeDistance(start, end, GeodesicMethod::Numerical), pi, 1.0e-9));
+}
+
+TEST_CASE("GeodesicSpheroidSeriesMatchesNumerical")
+{
+    Eigen::Vector3d axes(6378137.0, 6378137.0, 6356752.314245);
+    Ellipsoid spheroid = Ellipsoid(axes[0], axes[1], axes[2]);
+    GeodesicSolver solver(spheroid);
+    REQUIRE(solver.hasSpheroidSeries());
+
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<double> latitude(-1.5, 1.5);
+    std::uniform_real_distribution<double> longitude(-pi, pi);
+    for (int i = 0; i < 20; i++)
+    {
+        Eigen::Vector3d start = computeSurfacePoint(axes, latitude(generator), longitude(generator));
+        Eigen::Vector3d end = computeSurfacePoint(axes, latitude(generator), 0.8 * longitude(generator));
+        double series = solver.computeDistance(start, end, GeodesicMethod::SpheroidSeries);
+        double numerical = solver.computeDistance(start, end, GeodesicMethod::Numerical);
+        REQUIRE(isRelativelyClose(series, numerical, 1.0e-9));
+    }
+}
+
+TEST_CASE("GeodesicSpheroidSpecialCases")
+{
+    Eigen::Vector3d axes(6378137.0, 6378137.0, 6356752.314245);
+    GeodesicSolver solver(Ellipsoid(axes[0], axes[1], axes[2]));
+
+    // Along the equator, the distance is the arc length of the equator
+    double equatorial = solver.computeDistance(computeSurfacePoint(axes, 0.0, 0.1), computeSurfacePoint(axes, 0.0, 2.1));
+    REQUIRE(isRelativelyClose(equatorial, 2.0 * axes[0], 1.0e-14));
+
+    // Nearly antipodal points on the equator are joined by a shorter path than the equator, and exactly antipodal
+    // points by a meridian; the WGS84 half meridian is 20003931.4586 m
+    double half_meridian = solver.computeDistance(computeSurfacePoint(axes, 0.0, 0.0), computeSurfacePoint(axes, 0.0, pi));
+    double nearly_antipodal = solver.computeDistance(computeSurfacePoint(axes, 0.0, 0.0),
+                                                     computeSurfacePoint(axes, 0.0, 0.999 * pi));
+    REQUIRE(isRelativelyClose(half_meridian, 20003931.4586, 1.0e-11));
+    REQUIRE(nearly_antipodal < half_meridian);
+    REQUIRE(nearly_antipodal < 0.999 * pi * axes[0]);
+    REQUIRE(nearly_antipodal > 0.999 * half_meridian);
+
+    // Along a meridian, and over the pole, the series agrees with the numerical path
+    Eigen::Vector3d start = computeSurfacePoint(axes, -0.4, 0.5);
+    Eigen::Vector3d meridian_end = computeSurfacePoint(axes, 1.1, 0.5);
+    Eigen::Vector3d polar_end = computeSurfacePoint(axes, 1.1, 0.5 + pi);
+    REQUIRE(isRelativelyClose(solver.computeDistance(start, meridian_end),
+                              solver.computeDistance(start, meridian_end, GeodesicMethod::Numerical), 1.0e-9));
+    REQUIRE(isRelativelyClose(solver.computeDistance(start, polar_end),
+                              solver.computeDistance(start, polar_end, GeodesicMethod::Numerical), 1.0e-9));
+
+    // A spheroid whose symmetry axis is b, rotated and translated, gives the same distances
+    Ellipsoid rotated_spheroid = Ellipsoid(axes[0], axes[2], axes[0]);
+    Eigen::Matrix3d rotation = Eigen::AngleAxisd(0.9, Eigen::Vector3d(1.0, 1.0, 0.0).normalized()).toRotationMatrix();
+    Eigen::Matrix3d swap_axes;
+    swap_axes << 0.0, 1.0, 0.0,
+                 0.0, 0.0, 1.0,
+                 1.0, 0.0, 0.0;
+    Eigen::Vector3d position(100.0, -200.0, 300.0);
+    rotated_spheroid.setRotationMatrix(rotation);
+    rotated_spheroid.setPositionVector(position);
+    GeodesicSolver rotated_solver(rotated_spheroid);
+    REQUIRE(rotated_solver.hasSpheroidSeries());
+    REQUIRE(isRelativelyClose(rotated_solver.computeDistance(rotation * swap_axes * start + position,
+                                                             rotation * swap_axes * polar_end + position),
+                              solver.computeDistance(start, polar_end), 1.0e-12));
+}
+
+TEST_CASE("GeodesicProlateSpheroid")
+{
+    // A prolate spheroid with flattening -0.005, with the symmetry axis along a
+    Eigen::Vector3d axes(1.005, 1.0, 1.0);
+    GeodesicSolver solver(Ellipsoid(axes[0], axes[1], axes[2]));
+    REQUIRE(solver.hasSpheroidSeries());
+
+    std::mt19937 generator(11);
+    std::uniform_real_distribution<double> angle(-1.5, 1.5);
+    std::uniform_real_distribution<double> longitude(-pi, pi);
+    for (int i = 0; i < 20; i++)
+    {
+        // Points at reduced latitude measured from the y-z equator, so that the symmetry axis is x
+        double start_latitude = angle(generator);
+        double end_latitude = angle(generator);
+        double start_longitude = longitude(generator);
+        double end_longitude = start_longitude + 0.8 * longitude(generator);
+        Eigen::Vector3d start(axes[0] * std::sin(start_latitude), std::cos(start_latitude) * std::cos(start_longitude),
+                              std::cos(start_latitude) * std::sin(start_longitude));
+        Eigen::Vector3d end(axes[0] * std::sin(end_latitude), std::cos(end_latitude) * std::cos(end_longitude),
+                            std::cos(end_latitude) * std::sin(end_longitude));
+        double series = solver.computeDistance(start, end, GeodesicMethod::SpheroidSeries);
+        double numerical = solver.computeDistance(start, end, GeodesicMethod::Numerical);
+        REQUIRE(isRelativelyClose(series, numerical, 1.0e-9));
+    }
+
+    // On a prolate spheroid the equator is shortest even between antipodal points
+    Eigen::Vector3d start(0.0, 1.0, 0.0);
+    REQUIRE(isRelativelyClose(solver.computeDistance(start, -start), pi, 1.0e-12));
+
+    // Nearly antipodal points just off the equator, where the series alone may find a longer geodesic
+    Eigen::Vector3d near_start(axes[0] * std::sin(-0.003), std::cos(0.003), 0.0);
+    Eigen::Vector3d near_end(axes[0] * std::sin(0.003), std::cos(0.003) * std::cos(3.113), std::cos(0.003) * std::sin(3.113));
+    double near_distance = solver.computeDistance(near_start, near_end);
+    REQUIRE(near_distance <= solver.computeDistance(near_start, near_end, GeodesicMethod::Numerical));
+    REQUIRE(near_distance < pi);
+}
+
+TEST_CASE("GeodesicSeriesFlatteningLimit")
+{
+    // Spheroids at exactly 1% flattening are inside the series limit, even though (a - c) / a rounds above 0.01
+    REQUIRE(GeodesicSolver(Ellipsoid(1.0, 1.0, 0.99)).hasSpheroidSeries());
+    REQUIRE(GeodesicSolver(Ellipsoid(1.01, 1.0, 1.0)).hasSpheroidSeries());
+    REQUIRE(GeodesicSolver(Ellipsoid(1.0, 1.0, 0.98)).hasSpheroidSeries() == false);
+    REQUIRE(GeodesicSolver(Ellipsoid(1.03, 1.0, 1.0)).hasSpheroidSeries() == false);
+}
+
+TEST_CASE("GeodesicTriaxial")
+{
+    Eigen::Vector3d axes(3.0, 2.0, 1.0);
+    Ellipsoid ellipsoid = Ellipsoid(axes[0], axes[1], axes[2]);
+    GeodesicSolver solver(ellipsoid);
+    REQUIRE(solver.hasSpheroidSeries() == false);
+
+    Eigen::Vector3d start = computeSurfacePoint(axes, 0.3, 0.2);
+    Eigen::Vector3d end = computeSurfacePoint(axes, -0.5, 1.9);
+    double forward = solver.computeDistance(start, end);
+    double backward = solver.computeDistance(end, start);
+    REQUIRE(isRelativelyClose(forward, backward, 1.0e-9));
+    REQUIRE(forward > (end - start).norm());
+
+    // Along the principal ellipse in the xy plane, which is a geodesic, the distance is the ellipse arc length
+    Eigen::Vector3d arc_start = computeSurfacePoint(axes, 0.0, 0.0);
+    Eigen::Vector3d arc_end = computeSurfacePoint(axes, 0.0, 0.5 * pi);
+    double quarter_perimeter = 0.0;
+    const int intervals = 100000;
+    for (int k = 0; k < intervals; k++)
+    {
+        double t = (k + 0.5) * 0.5 * pi / intervals;
+        quarter_perimeter += std::hypot(axes[0] * std::sin(t), axes[1] * std::cos(t)) * 0.5 * pi / intervals;
+    }
+    REQUIRE(isRelativelyClose(solver.computeDistance(arc_start, arc_end), quarter_perimeter, 1.0e-8));
+}
+
+TEST_CASE("GeodesicBatchMatchesSingle")
+{
+    Eigen::Vector3d axes(6378137.0, 6378137.0, 6356752.314245);
+    GeodesicSolver solver(Ellipsoid(axes[0], axes[1], axes[2]));
+
+    Eigen::Matrix3Xd starts(3, 50);
+    Eigen::Matrix3Xd ends(3, 50);
+    for (int i = 0; i < 50; i++)
+    {
+        starts.col(i) = computeSurfacePoint(axes, -1.2 + 0.05 * i, 0.1 * i);
+        ends.col(i) = computeSurfacePoint(axes, 0.7 - 0.03 * i, -0.2 * i);
+    }
+
+    Workspace workspace;
+    VectorXdMap distances = solver.computeDistances(starts, ends, workspace);
+    REQUIRE(distances.size() == 50);
+    for (int i = 0; i < 50; i++)
+    {
+        REQUIRE(distances[i] == solver.computeDistance(starts.col(i), ends.col(i)));
+    }
+
+    REQUIRE_THROWS_AS(solver.computeDistances(starts, ends.leftCols(49), workspace), std::invalid_argument);
+}
@@ -0,0 +1,254 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "ellipsoid.hpp"
+#include "moving_ellipsoid.hpp"
+#include "workspace.hpp"
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    const double pi = std::acos(-1.0);
+
+    Eigen::Matrix3d rotationAboutZ(double angle)
+    {
+        return Eigen::AngleAxisd(angle, Eigen::Vector3d::UnitZ()).toRotationMatrix();
+    }
+
+    /**
+     * @brief Returns the first time at which the offset distance of the point from the moving ellipsoid reaches
+     * zero, by scanning and then bisecting.
+     */
+    double findFirstContactByScanning(const MovingEllipsoid& moving, const Eigen::Vector3d& point, double radius)
+    {
+        const int sample_count = 2000;
+        double previous_time = 0.0;
+        for (int k = 1; k <= sample_count; k++)
+        {
+            double time = static_cast<double>(k) / sample_count;
+            if (moving.getEllipsoid(time).computeOffsetDistance(point, radius) <= 0.0)
+            {
+                double lower = previous_time;
+                double upper = time;
+                for (int iteration = 0; iteration < 60; iteration++)
+                {
+                    double middle = 0.5 * (lower + upper);
+                    bool touching = moving.getEllipsoid(middle).computeOffsetDistance(point, radius) <= 0.0;
+                    (touching ? upper : lower) = middle;
+                }
+                return upper;
+            }
+            previous_time = time;
+        }
+        return std::numeric_limits<double>::infinity();
+    }
+}
+
+TEST_CASE("MovingEllipsoidInterpolation")
+{
+    Ellipsoid ellipsoid(3.0, 2.0, 1.0);
+    MovingEllipsoid moving(ellipsoid, Eigen::Vector3d(4.0, 0.0, 0.0), rotationAboutZ(0.5 * pi));
+
+    REQUIRE((moving.getPositionVector(0.25) - Eigen::Vector3d(1.0, 0.0, 0.0)).norm() < 1.0e-15);
+    REQUIRE((moving.getRotationMatrix(0.5) - rotationAboutZ(0.25 * pi)).norm() < 1.0e-14);
+    REQUIRE((moving.getRotationMatrix(1.0) - rotationAboutZ(0.5 * pi)).norm() < 1.0e-14);
+    REQUIRE(std::abs(moving.getMaxSpeed() - (4.0 + 0.5 * pi * 3.0)) < 1.0e-12);
+
+    Ellipsoid halfway = moving.getEllipsoid(0.5);
+    REQUIRE(halfway.getForm() == EllipsoidForm::Triaxial);
+    REQUIRE(halfway.getA() == 3.0);
+}
+
+TEST_CASE("MovingEllipsoidPointTimeOfImpact")
+{
+    // A unit sphere moving from x = -3 to x = 3 reaches the origin when its centre is at x = -1
+    Ellipsoid sphere(1.0, 1.0, 1.0);
+    sphere.setPositionVector(-3.0, 0.0, 0.0);
+    MovingEllipsoid translating(sphere, Eigen::Vector3d(3.0, 0.0, 0.0), Eigen::Matrix3d::Identity());
+    REQUIRE(std::abs(translating.computeTimeOfImpact(Eigen::Vector3d::Zero()) - 1.0 / 3.0) < 1.0e-8);
+    REQUIRE(std::isinf(translating.computeTimeOfImpact(Eigen::Vector3d(0.0, 1.5, 0.0))));
+    REQUIRE(translating.computeTimeOfImpact(Eigen::Vector3d(-3.5, 0.0, 0.0)) == 0.0);
+
+    // An ellipsoid turning about its centre sweeps its a axis through the point (0, 2, 0). In the ellipsoid frame
+    // the point is at (2 sin(phi), 2 cos(phi)), which is on the surface when sin^2(phi) = 27 / 32
+    Ellipsoid ellipsoid(3.0, 1.0, 1.0);
+    MovingEllipsoid rotating(ellipsoid, Eigen::Vector3d::Zero(), rotationAboutZ(0.5 * pi));
+    double expected_time = std::asin(std::sqrt(27.0 / 32.0)) / (0.5 * pi);
+    double contact_time = rotating.computeTimeOfImpact(Eigen::Vector3d(0.0, 2.0, 0.0));
+    REQUIRE(contact_time <= expected_time);
+    REQUIRE(std::abs(contact_time - expected_time) < 1.0e-7);
+}
+
+TEST_CASE("MovingEllipsoidRayTimeOfImpact")
+{
+    // A unit sphere crossing the y axis reaches the ray along it when its centre is at x = -1
+    Ellipsoid sphere(1.0, 1.0, 1.0);
+    sphere.setPositionVector(-4.0, 0.0, 0.0);
+    MovingEllipsoid translating(sphere, Eigen::Vector3d(4.0, 0.0, 0.0), Eigen::Matrix3d::Identity());
+    Eigen::Vector3d direction(0.0, 2.0, 0.0);
+    REQUIRE(std::abs(translating.computeRayTimeOfImpact(Eigen::Vector3d(0.0, -5.0, 0.0), direction) - 3.0 / 8.0) < 1.0e-8);
+
+    // The same sphere passes behind a ray starting beyond it, and first touches a ray starting at y = 0.5 at
+    // its origin, when the centre is at x = -sqrt(0.75)
+    REQUIRE(std::isinf(translating.computeRayTimeOfImpact(Eigen::Vector3d(0.0, 2.0, 0.0), direction)));
+    double origin_contact_time = translating.computeRayTimeOfImpact(Eigen::Vector3d(0.0, 0.5, 0.0), direction);
+    REQUIRE(std::abs(origin_contact_time - (4.0 - std::sqrt(0.75)) / 8.0) < 1.0e-8);
+
+    // A tilted ellipsoid moving and turning past an oblique ray agrees with the distance from the ray
+    Ellipsoid ellipsoid(2.0, 1.0, 0.5);
+    ellipsoid.setPositionVector(-5.0, 1.0, 0.0);
+    MovingEllipsoid moving(ellipsoid, Eigen::Vector3d(3.0, -1.0, 0.5), rotationAboutZ(1.0));
+    Eigen::Vector3d origin(0.0, -3.0, -1.0);
+    Eigen::Vector3d oblique = Eigen::Vector3d(0.2, 1.0, 0.3).normalized();
+    double contact_time = moving.computeRayTimeOfImpact(origin, oblique);
+    REQUIRE(contact_time < 1.0);
+
+    Ellipsoid at_contact = moving.getEllipsoid(contact_time);
+    double entry;
+    double exit;
+    REQUIRE(!at_contact.computeLineIntersection(origin, oblique, entry, exit));
+    Ellipsoid just_after = moving.getEllipsoid(contact_time + 1.0e-6);
+    REQUIRE(just_after.computeLineIntersection(origin, oblique, entry, exit));
+    REQUIRE(exit >= 0.0);
+}
+
+TEST_CASE("MovingEllipsoidPairTimeOfImpact")
+{
+    // Spheres of radius 1 and 0.5 closing at speed 3 from a gap of 2.5
+    Ellipsoid first(1.0, 1.0, 1.0);
+    first.setPositionVector(-3.0, 0.0, 0.0);
+    Ellipsoid second(0.5, 0.5, 0.5);
+    second.setPositionVector(1.0, 0.0, 0.0);
+    MovingEllipsoid first_moving(first, Eigen::Vector3d::Zero(), Eigen::Matrix3d::Identity());
+    MovingEllipsoid second_static(second, second.getPositionVector(), Eigen::Matrix3d::Identity());
+    REQUIRE(std::abs(first_moving.computeTimeOfImpact(second_static) - 5.0 / 6.0) < 1.0e-8);
+    REQUIRE(std::abs(second_static.computeTimeOfImpact(first_moving) - 5.0 / 6.0) < 1.0e-8);
+
+    MovingEllipsoid far_away(second, Eigen::Vector3d(1.0, 5.0, 0.0), Eigen::Matrix3d::Identity());
+    REQUIRE(std::isinf(first_moving.computeTimeOfImpact(far_away)));
+
+    // A turning and moving prolate spheroid meets a sphere when the sphere centre reaches its offset surface
+    Ellipsoid spheroid(2.0, 0.5, 0.5);
+    spheroid.setPositionVector(-1.0, 0.0, 0.0);
+    MovingEllipsoid turning(spheroid, Eigen::Vector3d(0.5, 0.0, 0.0), rotationAboutZ(0.5 * pi));
+    Ellipsoid ball(0.5, 0.5, 0.5);
+    ball.setPositionVector(0.0, 2.0, 0.0);
+    MovingEllipsoid ball_static(ball, ball.getPositionVector(), Eigen::Matrix3d::Identity());
+
+    double expected_time = findFirstContactByScanning(turning, ball.getPositionVector(), 0.5);
+    double contact_time = turning.computeTimeOfImpact(ball_static);
+    REQUIRE(expected_time < 1.0);
+    REQUIRE(contact_time <= expected_time + 1.0e-12);
+    REQUIRE(std::abs(contact_time - expected_time) < 1.0e-7);
+
+    // Two triaxial ellipsoids tumbling towards each other touch, but do not overlap, at the time of impact
+    Ellipsoid left(1.5, 1.0, 0.5);
+    left.setPositionVector(-4.0, 0.3, 0.0);
+    Ellipsoid right(1.0, 0.8, 0.6);
+    right.setPositionVector(4.0, -0.2, 0.1);
+    MovingEllipsoid left_moving(left, Eigen::Vector3d(0.5, 0.0, 0.2),
+                                Eigen::AngleAxisd(2.0, Eigen::Vector3d(1.0, 1.0, 0.0).normalized()).toRotationMatrix());
+    MovingEllipsoid right_moving(right, Eigen::Vector3d(-0.5, 0.1, 0.0),
+                                 Eigen::AngleAxisd(-1.0, Eigen::Vector3d(0.0, 1.0, 1.0).normalized()).toRotationMatrix());
+    double impact_time = left_moving.computeTimeOfImpact(right_moving);
+    REQUIRE(impact_time < 1.0);
+
+    Ellipsoid left_contact = left_moving.getEllipsoid(impact_time);
+    Ellipsoid right_contact = right_moving.getEllipsoid(impact_time);
+    std::mt19937_64 generator(19);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    double min_distance = std::numeric_limits<double>::infinity();
+    for (int sample = 0; sample < 20000; sample++)
+    {
+        Eigen::Vector3d unit(normal(generator), normal(generator), normal(generator));
+        Eigen::Vector3d local = unit.normalized().cwiseProduct(Eigen::Vector3d(1.5, 1.0, 0.5));
+        Eigen::Vector3d point = left_contact.getRotationMatrix() * local + left_contact.getPositionVector();
+        min_distance = std::min(min_distance, right_contact.computeSignedDistance(point));
+    }
+    REQUIRE(min_distance > 0.0);
+    REQUIRE(min_distance < 0.05);
+}
+
+TEST_CASE("MovingEllipsoidGrazingMiss")
+{
+    // Near a grazing approach the advancement steps shrink with the separation, so they cannot reach the end of the
+    // timestep on their own. A miss by three times the contact distance must still be reported as no contact.
+    Ellipsoid sphere(1.0, 1.0, 1.0);
+    sphere.setPositionVector(-2.0, 1.0 + 3.0e-9, 0.0);
+    MovingEllipsoid passing(sphere, Eigen::Vector3d(2.0, 1.0 + 3.0e-9, 0.0), Eigen::Matrix3d::Identity());
+    REQUIRE(std::isinf(passing.computeTimeOfImpact(Eigen::Vector3d::Zero())));
+
+    Ellipsoid fixed_sphere(1.0, 1.0, 1.0);
+    fixed_sphere.setPositionVector(0.0, -1.0, 0.0);
+    MovingEllipsoid fixed(fixed_sphere, fixed_sphere.getPositionVector(), Eigen::Matrix3d::Identity());
+    REQUIRE(std::isinf(passing.computeTimeOfImpact(fixed)));
+
+    // Very shallow contacts during a fast sweep, where the conservative steps alone would stall before the contact
+    for (double depth : {1.0e-7, 1.0e-8})
+    {
+        sphere.setPositionVector(-1000.0, 0.0, 0.0);
+        MovingEllipsoid sweeping(sphere, Eigen::Vector3d(1000.0, 0.0, 0.0), Eigen::Matrix3d::Identity());
+        double point_time = sweeping.computeTimeOfImpact(Eigen::Vector3d(0.0, 1.0 - depth, 0.0));
+        double expected_point_time = (1000.0 - std::sqrt(1.0 - (1.0 - depth) * (1.0 - depth))) / 2000.0;
+        REQUIRE(point_time <= expected_point_time);
+        REQUIRE(std::abs(point_time - expected_point_time) < 1.0e-7);
+
+        Ellipsoid target_sphere(1.0, 1.0, 1.0);
+        target_sphere.setPositionVector(0.0, 2.0 - depth, 0.0);
+        MovingEllipsoid target(target_sphere, target_sphere.getPositionVector(), Eigen::Matrix3d::Identity());
+        double pair_time = sweeping.computeTimeOfImpact(target);
+        double expected_pair_time = (1000.0 - std::sqrt(4.0 - (2.0 - depth) * (2.0 - depth))) / 2000.0;
+        REQUIRE(pair_time <= expected_pair_time);
+        REQUIRE(std::abs(pair_time - expected_pair_time) < 1.0e-7);
+    }
+
+    // A slightly deeper pass still touches, just before the point is reached at x = -sqrt(1 - 0.999^2)
+    sphere.setPositionVector(-2.0, 0.999, 0.0);
+    MovingEllipsoid touching(sphere, Eigen::Vector3d(2.0, 0.999, 0.0), Eigen::Matrix3d::Identity());
+    double expected_time = (2.0 - std::sqrt(1.0 - 0.999 * 0.999)) / 4.0;
+    double contact_time = touching.computeTimeOfImpact(Eigen::Vector3d::Zero());
+    REQUIRE(contact_time <= expected_time);
+    REQUIRE(std::abs(contact_time - expected_time) < 1.0e-7);
+}
+
+TEST_CASE("MovingEllipsoidBatchMatchesSingle")
+{
+    std::mt19937_64 generator(23);
+    std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+    std::vector<MovingEllipsoid> first;
+    std::vector<MovingEllipsoid> second;
+    Eigen::Matrix3Xd points(3, 64);
+    Eigen::Matrix3Xd directions(3, 64);
+    for (int i = 0; i < 64; i++)
+    {
+        Ellipsoid ellipsoid(1.0 + 0.5 * uniform(generator), 0.6, 0.4);
+        ellipsoid.setPositionVector(3.0 * uniform(generator), 3.0 * uniform(generator), 3.0 * uniform(generator));
+        Eigen::Vector3d end_position(3.0 * uniform(generator), 3.0 * uniform(generator), 3.0 * uniform(generator));
+        first.emplace_back(ellipsoid, end_position, rotationAboutZ(uniform(generator)));
+        second.emplace_back(ellipsoid, -end_position, rotationAboutZ(uniform(generator)));
+        points.col(i) = Eigen::Vector3d(uniform(generator), uniform(generator), uniform(generator));
+        directions.col(i) = Eigen::Vector3d(uniform(generator), uniform(generator), uniform(generator));
+    }
+
+    Workspace workspace;
+    VectorXdMap point_times = MovingEllipsoid::computeTimesOfImpact(first, points, workspace);
+    VectorXdMap ray_times = MovingEllipsoid::computeRayTimesOfImpact(first, points, directions, workspace);
+    VectorXdMap pair_times = MovingEllipsoid::computeTimesOfImpact(first, second, workspace);
+    for (int i = 0; i < 64; i++)
+    {
+        REQUIRE(point_times[i] == first[i].computeTimeOfImpact(points.col(i)));
+        REQUIRE(ray_times[i] == first[i].computeRayTimeOfImpact(points.col(i), directions.col(i)));
+        REQUIRE(pair_times[i] == first[i].computeTimeOfImpact(second[i]));
+    }
+
+    std::vector<MovingEllipsoid> short_second(second.begin(), second.end() - 1);
+    REQUIRE_THROWS_AS(MovingEllipsoid::computeTimesOfImpact(first, points.leftCols(63), workspace), std::invalid_argument);
+    REQUIRE_THROWS_AS(MovingEllipsoid::computeRayTimesOfImpact(first, points, directions.leftCols(63), workspace),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(MovingEllipsoid::computeTimesOfImpact(first, short_second, workspace), std::invalid_argument);
+}
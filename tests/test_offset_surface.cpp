@@ -0,0 +1,184 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "ellipsoid.hpp"
+#include "workspace.hpp"
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+namespace
+{
+    /**
+     * @brief Returns a rotated and translated triaxial ellipsoid.
+     */
+    Ellipsoid makePosedEllipsoid()
+    {
+        Ellipsoid ellipsoid(3.0, 2.0, 0.5);
+        Eigen::Matrix3d rotation = Eigen::AngleAxisd(0.7, Eigen::Vector3d(1.0, 2.0, 3.0).normalized()).toRotationMatrix();
+        Eigen::Vector3d position(1.0, -2.0, 0.5);
+        ellipsoid.setRotationMatrix(rotation);
+        ellipsoid.setPositionVector(position);
+        return ellipsoid;
+    }
+
+    Eigen::Matrix3Xd generatePoints(Eigen::Index point_count, double scale, std::mt19937_64& generator)
+    {
+        std::uniform_real_distribution<double> uniform(-scale, scale);
+        Eigen::Matrix3Xd points(3, point_count);
+        for (Eigen::Index i = 0; i < point_count; i++)
+        {
+            points.col(i) = Eigen::Vector3d(uniform(generator), uniform(generator), uniform(generator));
+        }
+        return points;
+    }
+}
+
+TEST_CASE("OffsetSurfaceSphere")
+{
+    Ellipsoid sphere(2.0, 2.0, 2.0);
+    sphere.setPositionVector(1.0, 0.0, 0.0);
+    double radius = 0.5;
+
+    REQUIRE(std::abs(sphere.computeOffsetDistance(Eigen::Vector3d(5.0, 0.0, 0.0), radius) - 1.5) < 1.0e-14);
+    REQUIRE(std::abs(sphere.computeOffsetDistance(Eigen::Vector3d(1.0, 0.0, 0.0), radius) + 2.5) < 1.0e-14);
+    REQUIRE(sphere.isInsideOffsetSurface(Eigen::Vector3d(1.0, 2.4, 0.0), radius));
+    REQUIRE(!sphere.isInsideOffsetSurface(Eigen::Vector3d(1.0, 2.6, 0.0), radius));
+
+    // A ray along the x axis from x = -5 meets the inflated sphere of radius 2.5 at x = -1.5
+    Eigen::Vector3d origin(-5.0, 0.0, 0.0);
+    REQUIRE(std::abs(sphere.computeOffsetRayIntersection(origin, Eigen::Vector3d(2.0, 0.0, 0.0), radius) - 1.75) < 1.0e-12);
+    REQUIRE(std::isinf(sphere.computeOffsetRayIntersection(origin, Eigen::Vector3d(-1.0, 0.0, 0.0), radius)));
+    REQUIRE(std::isinf(sphere.computeOffsetRayIntersection(Eigen::Vector3d(-5.0, 2.6, 0.0), Eigen::Vector3d::UnitX(), radius)));
+    REQUIRE(sphere.computeOffsetRayIntersection(Eigen::Vector3d(1.0, 1.0, 0.0), Eigen::Vector3d::UnitX(), radius) == 0.0);
+}
+
+TEST_CASE("OffsetSurfaceDistanceAndContainment")
+{
+    Ellipsoid ellipsoid = makePosedEllipsoid();
+    double radius = 0.75;
+    std::mt19937_64 generator(3);
+    Eigen::Matrix3Xd points = generatePoints(2000, 6.0, generator);
+    points.colwise() += ellipsoid.getPositionVector();
+
+    for (Eigen::Index i = 0; i < points.cols(); i++)
+    {
+        Eigen::Vector3d point = points.col(i);
+        double offset_distance = ellipsoid.computeOffsetDistance(point, radius);
+
+        // Outside the ellipsoid, the offset distance is the distance to the closest surface point less the radius
+        double surface_distance = (ellipsoid.computeClosestSurfacePoint(point) - point).norm();
+        double signed_distance = ellipsoid.computeSignedDistance(point);
+        REQUIRE(std::abs(std::abs(signed_distance) - surface_distance) < 1.0e-12);
+        REQUIRE(std::abs(offset_distance - (signed_distance - radius)) < 1.0e-12);
+
+        // The closest offset surface point lies on the offset surface, at the offset distance from the query
+        Eigen::Vector3d offset_point = ellipsoid.computeClosestOffsetSurfacePoint(point, radius);
+        REQUIRE(std::abs(ellipsoid.computeOffsetDistance(offset_point, radius)) < 1.0e-10);
+        REQUIRE(std::abs((offset_point - point).norm() - std::abs(offset_distance)) < 1.0e-10);
+
+        if (std::abs(offset_distance) > 1.0e-12)
+        {
+            REQUIRE(ellipsoid.isInsideOffsetSurface(point, radius) == (offset_distance < 0.0));
+        }
+    }
+
+    // A thin disc inflated by a large radius sticks out of the ellipsoid with its semi-axes increased by the radius
+    Ellipsoid disc(1.0, 1.0, 0.01);
+    REQUIRE(disc.isInsideOffsetSurface(Eigen::Vector3d(1.5, 0.0, 0.8), 1.0));
+    REQUIRE(!disc.isInsideOffsetSurface(Eigen::Vector3d(1.5, 0.0, 0.9), 1.0));
+}
+
+TEST_CASE("OffsetSurfaceRayIntersection")
+{
+    Ellipsoid ellipsoid = makePosedEllipsoid();
+    double radius = 0.75;
+    std::mt19937_64 generator(5);
+    Eigen::Matrix3Xd origins = generatePoints(500, 10.0, generator);
+    Eigen::Matrix3Xd targets = generatePoints(500, 3.0, generator);
+    origins.colwise() += ellipsoid.getPositionVector();
+    targets.colwise() += ellipsoid.getPositionVector();
+
+    int hit_count = 0;
+    for (Eigen::Index i = 0; i < origins.cols(); i++)
+    {
+        Eigen::Vector3d origin = origins.col(i);
+        Eigen::Vector3d direction = targets.col(i) - origin;
+        double parameter = ellipsoid.computeOffsetRayIntersection(origin, direction, radius);
+
+        if (ellipsoid.isInsideOffsetSurface(origin, radius))
+        {
+            REQUIRE(parameter == 0.0);
+            continue;
+        }
+
+        // The ray stays outside the offset surface up to the hit point, which lies on the offset surface
+        double end = std::isinf(parameter) ? 2.0 : parameter;
+        for (int k = 0; k < 200; k++)
+        {
+            Eigen::Vector3d point = origin + (end * k / 200.0) * direction;
+            REQUIRE(ellipsoid.computeOffsetDistance(point, radius) > -1.0e-9);
+        }
+        if (!std::isinf(parameter))
+        {
+            hit_count++;
+            REQUIRE(std::abs(ellipsoid.computeOffsetDistance(origin + parameter * direction, radius)) < 1.0e-9);
+        }
+    }
+    REQUIRE(hit_count > 100);
+}
+
+TEST_CASE("OffsetSurfaceBatchMatchesSingle")
+{
+    Ellipsoid ellipsoid = makePosedEllipsoid();
+    double radius = 0.25;
+    std::mt19937_64 generator(7);
+    Eigen::Matrix3Xd points = generatePoints(300, 5.0, generator);
+    Eigen::Matrix3Xd directions = generatePoints(300, 1.0, generator);
+    Workspace workspace;
+
+    VectorXdMap distances = ellipsoid.computeOffsetDistances(points, radius, workspace);
+    ArrayXbMap inside = ellipsoid.computeOffsetContainment(points, radius, workspace);
+    Matrix3XdMap offset_points = ellipsoid.computeClosestOffsetSurfacePoints(points, radius, workspace);
+    VectorXdMap parameters = ellipsoid.computeOffsetRayIntersections(points, directions, radius, workspace);
+
+    for (Eigen::Index i = 0; i < points.cols(); i++)
+    {
+        REQUIRE(distances[i] == ellipsoid.computeOffsetDistance(points.col(i), radius));
+        REQUIRE(inside[i] == ellipsoid.isInsideOffsetSurface(points.col(i), radius));
+        REQUIRE(offset_points.col(i) == ellipsoid.computeClosestOffsetSurfacePoint(points.col(i), radius));
+        REQUIRE(parameters[i] == ellipsoid.computeOffsetRayIntersection(points.col(i), directions.col(i), radius));
+    }
+}
+
+TEST_CASE("OffsetSurfaceRejectsInvalidInputs")
+{
+    Ellipsoid ellipsoid = makePosedEllipsoid();
+    std::mt19937_64 generator(9);
+    Eigen::Matrix3Xd points = generatePoints(10, 5.0, generator);
+    Eigen::Matrix3Xd directions = generatePoints(10, 1.0, generator);
+    Eigen::Vector3d point = points.col(0);
+    Workspace workspace;
+
+    // Mismatched ray batches
+    REQUIRE_THROWS_AS(ellipsoid.computeOffsetRayIntersections(points, directions.leftCols(9), 0.25, workspace),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(ellipsoid.computeOffsetRayIntersections(points.leftCols(9), directions, 0.25, workspace),
+                      std::invalid_argument);
+
+    // Negative offset radii, for single and batched queries
+    REQUIRE_THROWS_AS(ellipsoid.computeOffsetDistance(point, -0.25), std::invalid_argument);
+    REQUIRE_THROWS_AS(ellipsoid.isInsideOffsetSurface(point, -0.25), std::invalid_argument);
+    REQUIRE_THROWS_AS(ellipsoid.computeClosestOffsetSurfacePoint(point, -0.25), std::invalid_argument);
+    REQUIRE_THROWS_AS(ellipsoid.computeOffsetRayIntersection(point, directions.col(0), -0.25), std::invalid_argument);
+    REQUIRE_THROWS_AS(ellipsoid.computeOffsetDistances(points, -0.25, workspace), std::invalid_argument);
+    REQUIRE_THROWS_AS(ellipsoid.computeOffsetContainment(points, -0.25, workspace), std::invalid_argument);
+    REQUIRE_THROWS_AS(ellipsoid.computeClosestOffsetSurfacePoints(points, -0.25, workspace), std::invalid_argument);
+    REQUIRE_THROWS_AS(ellipsoid.computeOffsetRayIntersections(points, directions, -0.25, workspace),
+                      std::invalid_argument);
+
+    // A zero radius is the ellipsoid itself
+    REQUIRE(ellipsoid.computeOffsetDistance(point, 0.0) == ellipsoid.computeSignedDistance(point));
+}
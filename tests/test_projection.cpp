@@ -0,0 +1,171 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "camera.hpp"
+#include "ellipse.hpp"
+#include "ellipsoid.hpp"
+#include "workspace.hpp"
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+    const double pi = std::acos(-1.0);
+
+    /**
+     * @brief Returns the world direction of the ray through the given pixel of a perspective camera.
+     */
+    Eigen::Vector3d computePixelRay(const Camera& camera, const Eigen::Vector2d& pixel, double focal_length,
+                                    const Eigen::Vector2d& principal_point)
+    {
+        Eigen::Vector3d camera_direction((pixel - principal_point).x() / focal_length,
+                                         (pixel - principal_point).y() / focal_length, 1.0);
+        return camera.getRotationMatrix() * camera_direction;
+    }
+
+    /**
+     * @brief Returns the point at the given angle on the ellipse scaled by the given factor about its centre.
+     */
+    Eigen::Vector2d computeOutlinePoint(const Ellipse& ellipse, double angle, double scale)
+    {
+        Eigen::Vector2d local(ellipse.getA() * std::cos(angle), ellipse.getB() * std::sin(angle));
+        return ellipse.getPositionVector() + scale * (ellipse.getRotationMatrix() * local);
+    }
+}
+
+TEST_CASE("ProjectionOrthographic")
+{
+    Camera camera(CameraModel::Orthographic, 10.0, 10.0, Eigen::Vector2d(320.0, 240.0));
+    Ellipsoid ellipsoid(3.0, 2.0, 1.0);
+    ellipsoid.setPositionVector(1.0, -2.0, 5.0);
+    Eigen::Matrix3d rotation = Eigen::AngleAxisd(0.4, Eigen::Vector3d::UnitZ()).toRotationMatrix();
+    ellipsoid.setRotationMatrix(rotation);
+
+    Ellipse outline;
+    REQUIRE(camera.projectEllipsoid(ellipsoid, outline));
+    REQUIRE(std::abs(outline.getA() - 30.0) < 1.0e-9);
+    REQUIRE(std::abs(outline.getB() - 20.0) < 1.0e-9);
+    REQUIRE((outline.getPositionVector() - Eigen::Vector2d(330.0, 220.0)).norm() < 1.0e-9);
+    Eigen::Vector2d a_direction = outline.getRotationMatrix().col(0);
+    REQUIRE(std::abs(std::abs(a_direction.dot(Eigen::Vector2d(std::cos(0.4), std::sin(0.4)))) - 1.0) < 1.0e-12);
+    REQUIRE(std::abs(outline.getRotationMatrix().determinant() - 1.0) < 1.0e-12);
+}
+
+TEST_CASE("ProjectionPerspectiveSphere")
+{
+    // A sphere of radius r at distance d on the optical axis subtends a circle of radius f r / sqrt(d^2 - r^2)
+    Camera camera(CameraModel::Perspective, 800.0, 800.0, Eigen::Vector2d(640.0, 360.0));
+    Ellipsoid sphere(2.0, 2.0, 2.0);
+    sphere.setPositionVector(0.0, 0.0, 10.0);
+
+    Ellipse outline;
+    REQUIRE(camera.projectEllipsoid(sphere, outline));
+    double radius = 800.0 * 2.0 / std::sqrt(96.0);
+    REQUIRE(std::abs(outline.getA() - radius) < 1.0e-9);
+    REQUIRE(std::abs(outline.getB() - radius) < 1.0e-9);
+    REQUIRE((outline.getPositionVector() - Eigen::Vector2d(640.0, 360.0)).norm() < 1.0e-9);
+
+    // Off axis, the outline of a sphere is elongated towards the principal point and is not centred on the
+    // projected centre
+    sphere.setPositionVector(6.0, 0.0, 10.0);
+    REQUIRE(camera.projectEllipsoid(sphere, outline));
+    REQUIRE(outline.getA() > outline.getB() + 1.0);
+    REQUIRE(std::abs(outline.getRotationMatrix()(1, 0)) < 1.0e-12);
+    REQUIRE(outline.getPositionVector().x() > camera.projectPoint(sphere.getPositionVector()).x());
+}
+
+TEST_CASE("ProjectionPerspectiveOutlineIsTangent")
+{
+    std::mt19937_64 generator(7);
+    std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+    const double focal_length = 600.0;
+    const Eigen::Vector2d principal_point(400.0, 300.0);
+    Camera camera(CameraModel::Perspective, focal_length, focal_length, principal_point);
+    Eigen::Vector3d camera_position(1.0, -2.0, 0.5);
+    camera.setPositionVector(camera_position);
+    camera.setRotationMatrix(Eigen::AngleAxisd(0.3, Eigen::Vector3d(1.0, 2.0, -1.0).normalized()).toRotationMatrix());
+
+    for (int i = 0; i < 20; i++)
+    {
+        Ellipsoid ellipsoid(1.5 + 0.5 * uniform(generator), 1.0, 0.3 + 0.2 * uniform(generator));
+        Eigen::Vector3d camera_offset(2.0 * uniform(generator), 2.0 * uniform(generator), 8.0 + uniform(generator));
+        Eigen::Vector3d position = camera_position + camera.getRotationMatrix() * camera_offset;
+        Eigen::Matrix3d rotation = Eigen::AngleAxisd(pi * uniform(generator),
+            Eigen::Vector3d(uniform(generator), uniform(generator), uniform(generator)).normalized()).toRotationMatrix();
+        ellipsoid.setPositionVector(position);
+        ellipsoid.setRotationMatrix(rotation);
+
+        Ellipse outline;
+        REQUIRE(camera.projectEllipsoid(ellipsoid, outline));
+        REQUIRE(outline.getA() >= outline.getB());
+
+        // Rays just inside the outline hit the ellipsoid and rays just outside miss it
+        for (int k = 0; k < 16; k++)
+        {
+            double angle = 2.0 * pi * k / 16.0;
+            double entry, exit;
+            Eigen::Vector3d inner = computePixelRay(camera, computeOutlinePoint(outline, angle, 0.999), focal_length,
+                                                    principal_point);
+            Eigen::Vector3d outer = computePixelRay(camera, computeOutlinePoint(outline, angle, 1.001), focal_length,
+                                                    principal_point);
+            REQUIRE(ellipsoid.computeLineIntersection(camera_position, inner, entry, exit));
+            REQUIRE(!ellipsoid.computeLineIntersection(camera_position, outer, entry, exit));
+        }
+    }
+}
+
+TEST_CASE("ProjectionRejectsEllipsoidsNotInFront")
+{
+    Camera camera(CameraModel::Perspective, 800.0, 800.0, Eigen::Vector2d(640.0, 360.0));
+    Ellipse outline;
+
+    Ellipsoid behind(1.0, 1.0, 1.0);
+    behind.setPositionVector(0.0, 0.0, -5.0);
+    REQUIRE(!camera.projectEllipsoid(behind, outline));
+
+    Ellipsoid straddling(3.0, 1.0, 1.0);
+    straddling.setPositionVector(0.0, 4.0, 0.5);
+    Eigen::Matrix3d rotation = Eigen::AngleAxisd(pi / 2.0, Eigen::Vector3d::UnitY()).toRotationMatrix();
+    straddling.setRotationMatrix(rotation);
+    REQUIRE(!camera.projectEllipsoid(straddling, outline));
+
+    Camera orthographic(CameraModel::Orthographic, 1.0, 1.0, Eigen::Vector2d(0.0, 0.0));
+    REQUIRE(orthographic.projectEllipsoid(behind, outline));
+}
+
+TEST_CASE("ProjectionBatchMatchesSingle")
+{
+    std::mt19937_64 generator(11);
+    std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+    Camera camera(CameraModel::Perspective, 700.0, 650.0, Eigen::Vector2d(320.0, 240.0));
+    std::vector<Ellipsoid> ellipsoids;
+    for (int i = 0; i < 64; i++)
+    {
+        Ellipsoid ellipsoid(1.0 + 0.5 * uniform(generator), 0.6, 0.4);
+        ellipsoid.setPositionVector(3.0 * uniform(generator), 3.0 * uniform(generator), 4.0 * uniform(generator));
+        ellipsoids.push_back(ellipsoid);
+    }
+
+    Workspace workspace;
+    std::vector<Ellipse> outlines;
+    ArrayXbMap projected = camera.projectEllipsoids(ellipsoids, outlines, workspace);
+    REQUIRE(outlines.size() == ellipsoids.size());
+    int projected_count = 0;
+    for (int i = 0; i < 64; i++)
+    {
+        Ellipse outline;
+        REQUIRE(projected[i] == camera.projectEllipsoid(ellipsoids[i], outline));
+        if (projected[i])
+        {
+            projected_count++;
+            REQUIRE(outlines[i].getA() == outline.getA());
+            REQUIRE(outlines[i].getB() == outline.getB());
+            REQUIRE(outlines[i].getPositionVector() == outline.getPositionVector());
+            REQUIRE(outlines[i].getRotationMatrix() == outline.getRotationMatrix());
+        }
+    }
+    REQUIRE(projected_count > 0);
+    REQUIRE(projected_count < 64);
+}
@@ -0,0 +1,180 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "ellipse.hpp"
+#include "ellipsoid.hpp"
+#include "tessellator.hpp"
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    double computeSignedVolume(const UnitSphereMesh& mesh)
+    {
+        Eigen::Map<const Eigen::Matrix3Xf> vertices(mesh.vertices.data(), 3, mesh.getVertexCount());
+        double volume = 0.0;
+        for (std::size_t i = 0; i < mesh.indices.size(); i += 3)
+        {
+            Eigen::Vector3d a = vertices.col(mesh.indices[i]).cast<double>();
+            Eigen::Vector3d b = vertices.col(mesh.indices[i + 1]).cast<double>();
+            Eigen::Vector3d c = vertices.col(mesh.indices[i + 2]).cast<double>();
+            volume += a.dot(b.cross(c)) / 6.0;
+        }
+        return volume;
+    }
+}
+
+TEST_CASE("UnitSphereTemplates")
+{
+    Tessellator icosphere_tessellator(SphereTemplate::Icosphere, 3);
+    REQUIRE(icosphere_tessellator.getMaxLevel() == 3);
+    for (int level = 0; level <= 3; level++)
+    {
+        const UnitSphereMesh& mesh = icosphere_tessellator.getTemplate(level);
+        REQUIRE(mesh.getVertexCount() == 10 * (std::size_t(1) << (2 * level)) + 2);
+        REQUIRE(mesh.getIndexCount() == 60 * (std::size_t(1) << (2 * level)));
+
+        // Triangles are wound outwards, so the signed volume approaches that of the unit sphere from below
+        double volume = computeSignedVolume(mesh);
+        REQUIRE(volume > 0.0);
+        REQUIRE(volume < 4.0 * std::acos(-1.0) / 3.0);
+    }
+    REQUIRE(icosphere_tessellator.getTemplate(3).max_edge_angle < icosphere_tessellator.getTemplate(2).max_edge_angle);
+
+    Tessellator uv_tessellator(SphereTemplate::UVSphere, 2);
+    const UnitSphereMesh& uv_mesh = uv_tessellator.getTemplate(1);
+    REQUIRE(uv_mesh.getVertexCount() == 2 + 7 * 16);
+    REQUIRE(uv_mesh.getIndexCount() == 6 * 7 * 16);
+    REQUIRE(computeSignedVolume(uv_mesh) > 0.0);
+}
+
+TEST_CASE("EllipsoidMeshVerticesOnSurface")
+{
+    Ellipsoid ellipsoid = Ellipsoid(3.0, 2.0, 1.0);
+    Eigen::Matrix3d rotation = Eigen::AngleAxisd(0.4, Eigen::Vector3d(0.0, 1.0, 1.0).normalized()).toRotationMatrix();
+    Eigen::Vector3d position(1.0, 2.0, -3.0);
+    ellipsoid.setRotationMatrix(rotation);
+    ellipsoid.setPositionVector(position);
+
+    Tessellator tessellator;
+    const UnitSphereMesh& mesh = tessellator.getTemplate(2);
+    std::vector<float> vertices(3 * mesh.getVertexCount());
+    std::vector<float> normals(3 * mesh.getVertexCount());
+    std::vector<std::uint32_t> indices(mesh.getIndexCount());
+    tessellator.tessellateEllipsoid(ellipsoid, 2, vertices.data(), normals.data(), indices.data(), 7);
+
+    Eigen::Vector3d inverse_axes_squared(1.0 / 9.0, 1.0 / 4.0, 1.0);
+    for (std::size_t i = 0; i < mesh.getVertexCount(); i++)
+    {
+        Eigen::Vector3d vertex(vertices[3 * i], vertices[3 * i + 1], vertices[3 * i + 2]);
+        Eigen::Vector3d normal(normals[3 * i], normals[3 * i + 1], normals[3 * i + 2]);
+        Eigen::Vector3d local_vertex = rotation.transpose() * (vertex - position);
+        Eigen::Vector3d expected_normal = rotation * local_vertex.cwiseProduct(inverse_axes_squared).normalized();
+        REQUIRE(std::abs(local_vertex.cwiseProduct(local_vertex).dot(inverse_axes_squared) - 1.0) < 1.0e-5);
+        REQUIRE((normal - expected_normal).norm() < 1.0e-5);
+    }
+    for (std::size_t i = 0; i < indices.size(); i++)
+    {
+        REQUIRE(indices[i] == mesh.indices[i] + 7);
+    }
+}
+
+TEST_CASE("CurvatureAdaptiveRefinement")
+{
+    Tessellator tessellator;
+    Ellipsoid sphere = Ellipsoid(1.0, 1.0, 1.0);
+    Ellipsoid flat = Ellipsoid(1.0, 1.0, 0.1);
+
+    REQUIRE(tessellator.selectRefinementLevel(sphere, 1.0e-2) <= tessellator.selectRefinementLevel(sphere, 1.0e-3));
+    REQUIRE(tessellator.selectRefinementLevel(sphere, 1.0e-2) < tessellator.selectRefinementLevel(flat, 1.0e-2));
+    REQUIRE(tessellator.selectRefinementLevel(flat, 1.0e-12) == tessellator.getMaxLevel());
+}
+
+TEST_CASE("EllipsoidBatchMatchesSingleMeshes")
+{
+    std::vector<Ellipsoid> ellipsoids;
+    for (int i = 0; i < 50; i++)
+    {
+        Ellipsoid ellipsoid = Ellipsoid(1.0 + 0.1 * i, 1.0, 0.2 + 0.01 * i);
+        ellipsoid.setPositionVector(i, -i, 0.5 * i);
+        ellipsoids.push_back(ellipsoid);
+    }
+
+    Tessellator tessellator;
+    EllipsoidMeshLayout layout = tessellator.planEllipsoids(ellipsoids, 1.0e-2);
+    std::vector<float> vertices(3 * layout.vertex_count);
+    std::vector<std::uint32_t> indices(layout.index_count);
+    tessellator.tessellateEllipsoids(ellipsoids, layout, vertices.data(), nullptr, indices.data());
+
+    for (std::size_t i = 0; i < ellipsoids.size(); i++)
+    {
+        int level = layout.levels[i];
+        const UnitSphereMesh& mesh = tessellator.getTemplate(level);
+        std::vector<float> single_vertices(3 * mesh.getVertexCount());
+        std::vector<std::uint32_t> single_indices(mesh.getIndexCount());
+        tessellator.tessellateEllipsoid(ellipsoids[i], level, single_vertices.data(), nullptr, single_indices.data(),
+                                        static_cast<std::uint32_t>(layout.vertex_offsets[i]));
+
+        REQUIRE(std::equal(single_vertices.begin(), single_vertices.end(), vertices.begin() + 3 * layout.vertex_offsets[i]));
+        REQUIRE(std::equal(single_indices.begin(), single_indices.end(), indices.begin() + layout.index_offsets[i]));
+    }
+
+    EllipsoidMeshLayout uniform_layout = tessellator.planEllipsoids(ellipsoids, 1);
+    REQUIRE(uniform_layout.vertex_count == 50 * tessellator.getTemplate(1).getVertexCount());
+}
+
+TEST_CASE("EllipsePolylines")
+{
+    std::vector<Ellipse> ellipses = {Ellipse(2.0, 1.0), Ellipse(3.0, 0.5)};
+    Eigen::Vector2d position(4.0, -1.0);
+    ellipses[1].setPositionVector(position);
+
+    const int point_count = 64;
+    std::vector<float> vertices(2 * point_count * ellipses.size());
+    Tessellator::tessellateEllipses(ellipses, point_count, vertices.data());
+
+    for (std::size_t i = 0; i < ellipses.size(); i++)
+    {
+        for (int k = 0; k < point_count; k++)
+        {
+            std::size_t offset = 2 * (point_count * i + k);
+            Eigen::Vector2d local_point = Eigen::Vector2d(vertices[offset], vertices[offset + 1]) - ellipses[i].getPositionVector();
+            double x = local_point[0] / ellipses[i].getA();
+            double y = local_point[1] / ellipses[i].getB();
+            REQUIRE(std::abs(x * x + y * y - 1.0) < 1.0e-5);
+        }
+    }
+}
+
+TEST_CASE("TessellationRejectsInvalidSizes")
+{
+    // Level 7 has 163842 vertices, so 26215 ellipsoids need more vertices than 32-bit indices can address
+    Tessellator tessellator(SphereTemplate::Icosphere, 7);
+    std::vector<Ellipsoid> ellipsoids(26215, Ellipsoid(1.0, 1.0, 1.0));
+    REQUIRE_THROWS_AS(tessellator.planEllipsoids(ellipsoids, 7), std::length_error);
+    ellipsoids.pop_back();
+    REQUIRE(tessellator.planEllipsoids(ellipsoids, 7).vertex_count <= std::numeric_limits<std::uint32_t>::max());
+
+    // Levels beyond the cached templates, for one ellipsoid and for a batch layout
+    std::vector<float> mesh_vertices(3 * tessellator.getTemplate(7).getVertexCount());
+    std::vector<std::uint32_t> mesh_indices(tessellator.getTemplate(7).getIndexCount());
+    REQUIRE_THROWS_AS(tessellator.tessellateEllipsoid(ellipsoids[0], 8, mesh_vertices.data(), nullptr, mesh_indices.data()),
+                      std::out_of_range);
+    REQUIRE_THROWS_AS(tessellator.tessellateEllipsoid(ellipsoids[0], -1, mesh_vertices.data(), nullptr, mesh_indices.data()),
+                      std::out_of_range);
+    std::vector<Ellipsoid> pair(2, Ellipsoid(1.0, 1.0, 1.0));
+    EllipsoidMeshLayout layout = tessellator.planEllipsoids(pair, 0);
+    layout.levels[1] = 9;
+    REQUIRE_THROWS_AS(tessellator.tessellateEllipsoids(pair, layout, mesh_vertices.data(), nullptr, mesh_indices.data()),
+                      std::out_of_range);
+
+    std::vector<Ellipse> ellipses = {Ellipse(2.0, 1.0)};
+    std::vector<float> vertices(2);
+    REQUIRE_THROWS_AS(Tessellator::tessellateEllipses(ellipses, 0, vertices.data()), std::invalid_argument);
+    REQUIRE_THROWS_AS(Tessellator::tessellateEllipses(ellipses, -3, vertices.data()), std::invalid_argument);
+}
@@ -0,0 +1,71 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "ellipse.hpp"
+#include "ellipsoid.hpp"
+#include "workspace.hpp"
+#include <Eigen/Core>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <utility>
+
+TEST_CASE("WorkspaceAlignmentAndReset")
+{
+    Workspace workspace(128);
+    double* first = workspace.allocate<double>(3);
+    float* second = workspace.allocate<float>(1);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(first) % Workspace::alignment == 0);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(second) % Workspace::alignment == 0);
+
+    // Overflow the first block, then check that reset coalesces into a single block
+    workspace.allocate<double>(1000);
+    REQUIRE(workspace.getBlockCount() == 2);
+    std::size_t capacity = workspace.getCapacity();
+
+    workspace.reset();
+    REQUIRE(workspace.getBlockCount() == 1);
+    REQUIRE(workspace.getCapacity() == capacity);
+    REQUIRE(workspace.getUsedBytes() == 0);
+}
+
+TEST_CASE("EllipsoidBatchClosestSurfacePoints")
+{
+    Ellipsoid sphere = Ellipsoid(2.0, 2.0, 2.0);
+    sphere.setPositionVector(1.0, -1.0, 0.5);
+
+    Eigen::Matrix3Xd query_points = Eigen::Matrix3Xd::Random(3, 100) * 10.0;
+    Workspace workspace(256);
+
+    Matrix3XdMap contact_points = sphere.computeClosestSurfacePoints(query_points, workspace);
+    REQUIRE(contact_points.cols() == 100);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(contact_points.data()) % Workspace::alignment == 0);
+    for (Eigen::Index i = 0; i < query_points.cols(); i++)
+    {
+        REQUIRE(contact_points.col(i) == sphere.computeClosestSurfacePoint(query_points.col(i)));
+    }
+}
+
+TEST_CASE("WorkspaceMovedFromIsUsable")
+{
+    Workspace workspace(128);
+    workspace.allocate<double>(4);
+    Workspace moved(std::move(workspace));
+    REQUIRE(moved.getUsedBytes() == Workspace::alignment);
+
+    // The moved-from workspace starts again from an empty arena
+    workspace.reset();
+    double* values = workspace.allocate<double>(8);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(values) % Workspace::alignment == 0);
+    REQUIRE(workspace.getBlockCount() == 1);
+    workspace.reset();
+    REQUIRE(workspace.getUsedBytes() == 0);
+}
+
+TEST_CASE("WorkspaceRejectsOverflowingSizes")
+{
+    Workspace workspace(128);
+    std::size_t count = std::numeric_limits<std::size_t>::max() / sizeof(double) + 1;
+    REQUIRE_THROWS_AS(workspace.allocate<double>(count), std::bad_array_new_length);
+    REQUIRE_THROWS_AS(workspace.allocate<char>(std::numeric_limits<std::size_t>::max()), std::bad_array_new_length);
+    REQUIRE(workspace.getUsedBytes() == 0);
+}
@@ -0,0 +1,66 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "ellipse.hpp"
+#include "ellipsoid.hpp"
+#include "workspace.hpp"
+#include <Eigen/Core>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Count every heap allocation made by the test executable. This file is built as its own executable, as the
+// replacement allocation functions apply to the whole program.
+namespace
+{
+    std::atomic<std::size_t> allocation_count{0};
+}
+
+void* operator new(std::size_t size)
+{
+    allocation_count++;
+    if (void* pointer = std::malloc(size == 0 ? 1 : size)) { return pointer; }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    allocation_count++;
+    std::size_t align = static_cast<std::size_t>(alignment);
+    std::size_t rounded_size = ((size == 0 ? 1 : size) + align - 1) & ~(align - 1);
+    if (void* pointer = std::aligned_alloc(align, rounded_size)) { return pointer; }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { std::free(pointer); }
+
+TEST_CASE("BatchQueriesSteadyStateAllocationFree")
+{
+    Ellipsoid sphere = Ellipsoid(2.0, 2.0, 2.0);
+    Ellipsoid triaxial = Ellipsoid(3.0, 2.0, 1.0);
+    Ellipse circle = Ellipse(1.5, 1.5);
+    Eigen::Matrix3Xd query_points_3d = Eigen::Matrix3Xd::Random(3, 1000);
+    Eigen::Matrix2Xd query_points_2d = Eigen::Matrix2Xd::Random(2, 1000);
+    Workspace workspace(256);
+
+    // The first frame grows the workspace to its high-water mark, and the reset coalesces its blocks
+    sphere.computeClosestSurfacePoints(query_points_3d, workspace);
+    triaxial.computeClosestSurfacePoints(query_points_3d, workspace);
+    circle.computeClosestPerimeterPoints(query_points_2d, workspace);
+    workspace.reset();
+
+    std::size_t allocations_before = allocation_count.load();
+    for (int frame = 0; frame < 10; frame++)
+    {
+        sphere.computeClosestSurfacePoints(query_points_3d, workspace);
+        triaxial.computeClosestSurfacePoints(query_points_3d, workspace);
+        circle.computeClosestPerimeterPoints(query_points_2d, workspace);
+        workspace.reset();
+    }
+    std::size_t allocations_after = allocation_count.load();
+
+    REQUIRE(allocations_after == allocations_before);
+    REQUIRE(workspace.getBlockCount() == 1);
+}